@@ -36,6 +36,12 @@ public:
 
   bool initialize (OpenMode mode, Channel channel);
 
+  // Called by a source prior to writing to a sink, with the sample rate
+  // the device would prefer to deliver; returns the rate the sink would
+  // like to be written at. Sinks that can't adapt get 48kHz.
+
+  virtual int selectSampleRate (int /* preferred */) {return 48000;}
+
   bool isSequential () const override {return true;}
 
   size_t bytesPerFrame () const {return sizeof (qint16) * (Mono == m_channel ? 1 : 2);}
@@ -0,0 +1,170 @@
+#ifndef BIT_STREAM_HPP__
+#define BIT_STREAM_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <QVarLengthArray>
+
+// A sequence of bits, most significant first, packed into 64-bit words,
+// on which message packing and unpacking operate. Storage for the first
+// 128 bits is inline, which covers any frame, so that building a frame
+// doesn't allocate. Unused bits of the last word are always zero, so
+// reads past the end need no masking.
+
+class BitStream
+{
+public:
+
+  using Word = std::uint64_t;
+
+  static constexpr int WORD_BITS = 64;
+
+  // Constructors
+
+  BitStream() = default;
+
+  BitStream(std::initializer_list<bool> const bits)
+  {
+    for (auto const bit : bits) append(bit);
+  }
+
+  // Inline accessors
+
+  int  size()    const { return m_size;      }
+  bool isEmpty() const { return m_size == 0; }
+
+  bool
+  at(int const i) const
+  {
+    return (m_words[i / WORD_BITS] >> (WORD_BITS - 1 - i % WORD_BITS)) & 1;
+  }
+
+  // Read n bits, 0 <= n <= 64, starting at position i, as an integer;
+  // bits past the end read as zero.
+
+  Word
+  read(int const i,
+       int const n) const
+  {
+    if (n <= 0 || i >= m_size) return 0;
+
+    auto const word  = i / WORD_BITS;
+    auto const shift = i % WORD_BITS;
+
+    Word value = m_words[word] << shift;
+
+    if (shift && word + 1 < m_words.size()) value |= m_words[word + 1] >> (WORD_BITS - shift);
+
+    return n == WORD_BITS ? value : value >> (WORD_BITS - n);
+  }
+
+  // Index of the last bit having the value provided, or -1 if none does.
+
+  int
+  lastIndexOf(bool const bit) const
+  {
+    for (auto i = m_size; i-- > 0;) if (at(i) == bit) return i;
+    return -1;
+  }
+
+  // Bits [i, i + n), clamped to the stream as QList::mid() would; a
+  // negative count means through the end.
+
+  BitStream
+  mid(int i,
+      int n = -1) const
+  {
+    if (i > m_size) return {};
+
+    if (i < 0)
+    {
+      if (n < 0 || n + i >= m_size) return *this;
+      if (n + i <= 0)               return {};
+
+      n += i;
+      i  = 0;
+    }
+    else if (static_cast<unsigned>(n) > static_cast<unsigned>(m_size - i))
+    {
+      n = m_size - i;
+    }
+
+    BitStream result;
+
+    for (; n >= WORD_BITS; n -= WORD_BITS, i += WORD_BITS) result.append(read(i, WORD_BITS), WORD_BITS);
+
+    result.append(read(i, n), n);
+
+    return result;
+  }
+
+  // Manipulators
+
+  void
+  append(bool const bit)
+  {
+    append(static_cast<Word>(bit), 1);
+  }
+
+  // Append the low n bits of value, 0 <= n <= 64, most significant first.
+
+  void
+  append(Word const value,
+         int  const n)
+  {
+    if (n <= 0) return;
+
+    auto const bits  = n == WORD_BITS ? value : value & ((Word{1} << n) - 1);
+    auto const shift = m_size % WORD_BITS;
+    auto const used  = (m_size + n + WORD_BITS - 1) / WORD_BITS;
+
+    while (m_words.size() < used) m_words.append(0);
+
+    auto const word = m_size / WORD_BITS;
+
+    if (shift + n <= WORD_BITS)
+    {
+      m_words[word] |= bits << (WORD_BITS - shift - n);
+    }
+    else
+    {
+      m_words[word]     |= bits >> (shift + n - WORD_BITS);
+      m_words[word + 1] |= bits << (2 * WORD_BITS - shift - n);
+    }
+
+    m_size += n;
+  }
+
+  void
+  append(BitStream const & other)
+  {
+    for (int i = 0; i < other.m_size; i += WORD_BITS)
+    {
+      auto const n = std::min(WORD_BITS, other.m_size - i);
+      append(other.read(i, n), n);
+    }
+  }
+
+  void clear() { m_words.clear(); m_size = 0; }
+
+  // Operators
+
+  BitStream & operator+=(BitStream const & other) { append(other); return *this; }
+  BitStream & operator<<(BitStream const & other) { append(other); return *this; }
+
+  friend BitStream
+  operator+(BitStream         lhs,
+            BitStream const & rhs)
+  {
+    lhs.append(rhs);
+    return lhs;
+  }
+
+private:
+
+  QVarLengthArray<Word, 2> m_words;
+  int                      m_size = 0;
+};
+
+#endif
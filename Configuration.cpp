@@ -645,6 +645,9 @@ private:
   bool transmit_off_at_startup_;
   bool monitor_last_used_;
   bool insert_blank_;
+  bool min_sum_decoder_;
+  bool early_decode_;
+  bool decoder_metrics_;
   bool DXCC_;
   bool ppfx_;
   bool miles_;
@@ -809,6 +812,9 @@ bool Configuration::monitor_off_at_startup () const {return m_->monitor_off_at_s
 bool Configuration::transmit_off_at_startup () const { return m_->transmit_off_at_startup_; }
 bool Configuration::monitor_last_used () const {return m_->rig_is_dummy_ || m_->monitor_last_used_;}
 bool Configuration::insert_blank () const {return m_->insert_blank_;}
+bool Configuration::min_sum_decoder () const {return m_->min_sum_decoder_;}
+bool Configuration::early_decode () const {return m_->early_decode_;}
+bool Configuration::decoder_metrics () const {return m_->decoder_metrics_;}
 bool Configuration::DXCC () const {return m_->DXCC_;}
 bool Configuration::ppfx() const {return m_->ppfx_;}
 bool Configuration::miles () const {return m_->miles_;}
@@ -2006,6 +2012,9 @@ void Configuration::impl::read_settings ()
   rig_params_.ptt_port = settings_->value ("PTTport").toString ();
   data_mode_ = settings_->value ("DataMode", QVariant::fromValue (data_mode_none)).value<Configuration::DataMode> ();
   insert_blank_ = settings_->value ("InsertBlank", false).toBool ();
+  min_sum_decoder_ = settings_->value ("MinSumDecoder", false).toBool ();
+  early_decode_ = settings_->value ("EarlyDecode", false).toBool ();
+  decoder_metrics_ = settings_->value ("DecoderMetrics", false).toBool ();
   DXCC_ = settings_->value ("DXCCEntity", false).toBool ();
   ppfx_ = settings_->value ("PrincipalPrefix", false).toBool ();
   miles_ = settings_->value ("Miles", false).toBool ();
@@ -2204,6 +2213,9 @@ void Configuration::impl::write_settings ()
   settings_->setValue ("CATHandshake", QVariant::fromValue (rig_params_.handshake));
   settings_->setValue ("DataMode", QVariant::fromValue (data_mode_));
   settings_->setValue ("InsertBlank", insert_blank_);
+  settings_->setValue ("MinSumDecoder", min_sum_decoder_);
+  settings_->setValue ("EarlyDecode", early_decode_);
+  settings_->setValue ("DecoderMetrics", decoder_metrics_);
   settings_->setValue ("DXCCEntity", DXCC_);
   settings_->setValue ("PrincipalPrefix", ppfx_);
   settings_->setValue ("Miles", miles_);
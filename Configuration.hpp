@@ -145,6 +145,9 @@ public:
   bool transmit_off_at_startup () const;
   bool monitor_last_used () const;
   bool insert_blank () const;
+  bool min_sum_decoder () const;
+  bool early_decode () const;
+  bool decoder_metrics () const;
   bool DXCC () const;
   bool ppfx() const;
   bool miles () const;
@@ -0,0 +1,244 @@
+#include "Decimator.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+/******************************************************************************/
+// Lowpass Filters
+/******************************************************************************/
+
+namespace
+{
+  // Filter coefficients for an FIR lowpass filter designed using ScopeFIR,
+  // used for the common case of 48kHz input.
+  //
+  //   fsample     = 48000 Hz
+  //   Ntaps       = 49
+  //   fc          = 4500  Hz
+  //   fstop       = 6000  Hz
+  //   Ripple      = 1     dB
+  //   Stop Atten  = 40    dB
+  //   fout        = 12000 Hz
+
+  constexpr std::array<float, 49> LOWPASS
+  {
+     0.000861074040f,  0.010051920210f,  0.010161983649f,  0.011363155076f,
+     0.008706594219f,  0.002613872664f, -0.005202883094f, -0.011720748164f,
+    -0.013752163325f, -0.009431602741f,  0.000539063909f,  0.012636767098f,
+     0.021494659597f,  0.021951235065f,  0.011564169382f, -0.007656470131f,
+    -0.028965787341f, -0.042637874109f, -0.039203309748f, -0.013153301537f,
+     0.034320769178f,  0.094717832646f,  0.154224604789f,  0.197758325022f,
+     0.213715139513f,  0.197758325022f,  0.154224604789f,  0.094717832646f,
+     0.034320769178f, -0.013153301537f, -0.039203309748f, -0.042637874109f,
+    -0.028965787341f, -0.007656470131f,  0.011564169382f,  0.021951235065f,
+     0.021494659597f,  0.012636767098f,  0.000539063909f, -0.009431602741f,
+    -0.013752163325f, -0.011720748164f, -0.005202883094f,  0.002613872664f,
+     0.008706594219f,  0.011363155076f,  0.010161983649f,  0.010051920210f,
+     0.000861074040f
+  };
+
+  // Input rates we're prepared to deal with.
+
+  constexpr std::array<unsigned, 4> RATES
+  {
+    44100, 48000, 96000, 192000
+  };
+
+  // Design parameters for the filters we construct for rates other than
+  // 48kHz; the same passband and stopband as the ScopeFIR filter, with
+  // rather more attenuation, since the taps are cheap.
+
+  constexpr double PASS  = 4500.0;
+  constexpr double STOP  = 6000.0;
+  constexpr double ATTEN = 60.0;
+
+  // Modified Bessel function of the first kind, order zero; the series
+  // converges rapidly for the range of arguments a Kaiser window needs.
+
+  double
+  besselI0(double const x)
+  {
+    double sum  = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; term > sum * 1e-12; ++k)
+    {
+      term *= (x / (2.0 * k)) * (x / (2.0 * k));
+      sum  += term;
+    }
+
+    return sum;
+  }
+
+  // Kaiser-windowed sinc lowpass for the upsampled rate, having a length
+  // that's a multiple of the upsampling factor, normalized to a DC gain
+  // equal to that factor, making up for the zeros inserted by upsampling.
+
+  std::vector<double>
+  kaiser(double const rate,
+         int    const l)
+  {
+    auto const beta   = 0.1102 * (ATTEN - 8.7);
+    auto const width  = 2.0 * std::numbers::pi * (STOP - PASS) / rate;
+    auto const length = static_cast<int>(std::ceil((ATTEN - 7.95) / (2.285 * width))) + 1;
+    auto const taps   = (length + l - 1) / l * l;
+    auto const cutoff = (PASS + STOP) / rate;
+    auto const center = (taps - 1) / 2.0;
+
+    std::vector<double> h(taps);
+
+    for (int m = 0; m < taps; ++m)
+    {
+      auto const t = m - center;
+      auto const r = t / (center + 0.5);
+      auto const x = std::numbers::pi * cutoff * t;
+
+      h[m] = cutoff * (x == 0.0 ? 1.0 : std::sin(x) / x)
+           * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r)))
+           / besselI0(beta);
+    }
+
+    auto const gain = l / std::accumulate(h.begin(), h.end(), 0.0);
+
+    for (auto & tap : h) tap *= gain;
+
+    return h;
+  }
+}
+
+/******************************************************************************/
+// Public Interface
+/******************************************************************************/
+
+bool
+Decimator::supports(unsigned const rate)
+{
+  return std::find(RATES.begin(), RATES.end(), rate) != RATES.end();
+}
+
+// Reduce the ratio of output rate to input rate to L/M, build the
+// prototype filter, and split it into L phases, each a column in the
+// phase matrix, reversed such that a dot product with a contiguous run
+// of history ending at the newest input sample yields an output.
+//
+// The history starts out with enough zeros to satisfy the filter, and
+// the first output is positioned such that at 48kHz, we produce output
+// identically to the per-sample filter this replaced.
+
+Decimator::Decimator(unsigned const rate)
+: m_rate(rate)
+{
+  assert(supports(rate));
+
+  auto const divisor = std::gcd(OUTPUT_RATE, rate);
+
+  m_l = OUTPUT_RATE / divisor;
+  m_m = rate        / divisor;
+
+  auto const h = m_l == 1 && m_m == 4
+               ? std::vector<double>(LOWPASS.begin(), LOWPASS.end())
+               : kaiser(static_cast<double>(rate) * m_l, static_cast<int>(m_l));
+
+  m_taps   = static_cast<Eigen::Index>(h.size() + m_l - 1) / m_l;
+  m_phases = Phases::Zero(m_taps, m_l);
+
+  for (Eigen::Index phase = 0; phase < m_l; ++phase)
+  {
+    for (Eigen::Index j = 0; j < m_taps; ++j)
+    {
+      if (auto const index  = static_cast<std::size_t>(phase + (m_taps - 1 - j) * m_l);
+                     index  < h.size())
+      {
+        m_phases(j, phase) = static_cast<float>(h[index]);
+      }
+    }
+  }
+
+  m_history.assign(m_taps - 1, 0.0f);
+  m_position = (m_taps - 1) * m_l + (m_m - 1);
+}
+
+std::size_t
+Decimator::needed(std::size_t const outputs) const
+{
+  if (!outputs) return 0;
+
+  auto const last = (m_position + static_cast<std::int64_t>(outputs - 1) * m_m) / m_l;
+
+  return static_cast<std::size_t>(std::max<std::int64_t>(0, last + 1 - static_cast<std::int64_t>(m_history.size())));
+}
+
+std::size_t
+Decimator::produced(std::size_t const frames) const
+{
+  auto const limit = static_cast<std::int64_t>(m_history.size() + frames) * m_l;
+
+  return limit > m_position
+       ? static_cast<std::size_t>((limit - 1 - m_position) / m_m + 1)
+       : 0;
+}
+
+// Append the input to the history, and compute every output that it now
+// covers. When there's only a single phase, which is the case for all of
+// the integral ratios, the outputs are the product of a strided view of
+// the history with the filter, computed as a single matrix-vector product;
+// otherwise, each output is a dot product with the phase it falls on.
+//
+// Having done so, discard all history that the next output won't need;
+// that's the only time we move anything around.
+
+std::size_t
+Decimator::process(short const * const input,
+                   std::size_t   const frames,
+                   short       *       output)
+{
+  auto const start = m_history.size();
+
+  m_history.resize(start + frames);
+  std::copy(input, input + frames, m_history.begin() + start);
+
+  auto const size  = static_cast<std::int64_t>(m_history.size());
+  auto const count = static_cast<Eigen::Index>(produced(0));
+
+  auto const convert = [](float const value)
+  {
+    return static_cast<short>(std::clamp(std::round(value), -32768.0f, 32767.0f));
+  };
+
+  if (m_l == 1)
+  {
+    using History = Eigen::Map<Eigen::MatrixXf const, 0, Eigen::OuterStride<>>;
+
+    History const history(m_history.data() + m_position - (m_taps - 1),
+                          m_taps,
+                          count,
+                          Eigen::OuterStride<>(m_m));
+
+    m_output.noalias() = history.transpose() * m_phases.col(0);
+    m_position        += count * m_m;
+
+    output = std::transform(m_output.data(), m_output.data() + count, output, convert);
+  }
+  else
+  {
+    using History = Eigen::Map<Eigen::VectorXf const>;
+
+    for (Eigen::Index n = 0; n < count; ++n, m_position += m_m)
+    {
+      auto const base  = m_position / m_l;
+      auto const phase = m_position % m_l;
+
+      *output++ = convert(m_phases.col(phase).dot(History(m_history.data() + base - (m_taps - 1), m_taps)));
+    }
+  }
+
+  auto const drop = size - (m_taps - 1);
+
+  m_history.erase(m_history.begin(), m_history.begin() + drop);
+  m_position -= drop * m_l;
+
+  return static_cast<std::size_t>(count);
+}
@@ -0,0 +1,71 @@
+#ifndef DECIMATOR_HPP__
+#define DECIMATOR_HPP__
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vendor/Eigen/Dense>
+
+// Polyphase rational resampler, used to decimate input data to 12kHz,
+// both for live audio, by the Detector, and for any recorded audio that
+// wasn't captured at 12kHz.
+//
+// Conceptually, input is upsampled by L, through a lowpass FIR, and then
+// downsampled by M; in practice, the FIR is split into L phases, each of
+// which is applied only where it would produce an output, so we never
+// compute anything that would be discarded. Input is processed a block
+// at a time, retaining only as much of it as the filter needs to carry
+// on with the next block; nothing is shifted on a per-sample basis.
+
+class Decimator final
+{
+public:
+
+  // Rate at which we produce output.
+
+  static constexpr unsigned OUTPUT_RATE = 12000;
+
+  // Returns true if we're able to decimate input at the provided rate.
+
+  static bool supports(unsigned rate);
+
+  // Constructor; the input rate must be one that we support.
+
+  explicit Decimator(unsigned rate = 48000);
+
+  // Inline accessors
+
+  unsigned rate() const { return m_rate; }
+
+  // Number of input frames required in order to produce the requested
+  // number of output samples, and number of output samples that would
+  // be produced from the provided number of input frames, respectively.
+
+  std::size_t needed  (std::size_t outputs) const;
+  std::size_t produced(std::size_t frames)  const;
+
+  // Process input frames, writing output samples, the count of which is
+  // returned, and which will be that reported by produced() for the same
+  // number of frames.
+
+  std::size_t process(short const * input,
+                      std::size_t   frames,
+                      short       * output);
+
+private:
+
+  using Phases = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>;
+
+  // Data members; position is that of the next output sample, in terms
+  // of the upsampled input, relative to the start of the history.
+
+  unsigned             m_rate;
+  std::int64_t         m_l;
+  std::int64_t         m_m;
+  Eigen::Index         m_taps;
+  Phases               m_phases;
+  std::vector<float>   m_history;
+  Eigen::VectorXf      m_output;
+  std::int64_t         m_position;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "DecoderMetrics.hpp"
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <QVariantList>
+#include "JS8Submode.hpp"
+
+/******************************************************************************/
+// Local Routines
+/******************************************************************************/
+
+namespace
+{
+  // Record a duration in a histogram.
+
+  void
+  count(DecoderMetrics::Histogram       & histogram,
+        std::chrono::nanoseconds  const   duration)
+  {
+    auto const us     = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    auto const bucket = std::min<std::size_t>(std::bit_width(static_cast<std::uint64_t>(std::max<qint64>(0, us))),
+                                              DecoderMetrics::BUCKETS - 1);
+
+    ++histogram[bucket];
+  }
+
+  // Convert counts to a list, for reporting.
+
+  template <typename Counts>
+  QVariantList
+  list(Counts const & counts)
+  {
+    QVariantList result;
+
+    result.reserve(static_cast<qsizetype>(counts.size()));
+
+    for (auto const value : counts) result.append(value);
+
+    return result;
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+DecoderMetrics::DecoderMetrics()
+  : m_start(std::chrono::steady_clock::now())
+{}
+
+void
+DecoderMetrics::record(JS8::Event::Stats const & stats)
+{
+  auto & submode = m_submodes[stats.mode];
+
+  submode.decodes      += 1;
+  submode.bpDecodes    += stats.bpDecodes;
+  submode.bpIterations += stats.bpIterations;
+
+  for (std::size_t i = 0; i < submode.candidates.size(); ++i)
+  {
+    submode.candidates[i] += stats.candidates[i];
+    submode.decoded[i]    += stats.decoded[i];
+  }
+
+  count(submode.lag,       stats.lag);
+  count(submode.wall,      std::accumulate(stats.timings.passes.begin(),
+                                           stats.timings.passes.end(),
+                                           std::chrono::nanoseconds{}));
+  count(submode.stages[0], stats.timings.sync);
+  count(submode.stages[1], stats.timings.candidates);
+  count(submode.stages[2], stats.timings.downsample);
+  count(submode.stages[3], stats.timings.bpdecode);
+  count(submode.stages[4], stats.timings.subtract);
+}
+
+// The report has the length of the interval and the upper bound of each
+// histogram bucket, along with, for each submode decoded, its period, so
+// that decode durations can be compared to it, counts by pass of what was
+// decoded, and histograms of the time spent waiting on the decoder, the
+// time spent decoding, and the time spent in each stage of decoding.
+
+QVariantMap
+DecoderMetrics::take()
+{
+  auto const now = std::chrono::steady_clock::now();
+
+  QVariantList bounds;
+  QVariantMap  submodes;
+
+  for (std::size_t i = 0; i < BUCKETS; ++i) bounds.append(i + 1 < BUCKETS ? qint64{1} << i : qint64{-1});
+
+  for (auto const & [mode, submode] : m_submodes)
+  {
+    submodes[JS8::Submode::name(mode)] = QVariantMap
+    {
+      {"PERIOD_MS",        JS8::Submode::period(mode) * 1000},
+      {"DECODES",          submode.decodes},
+      {"CANDIDATES",       list(submode.candidates)},
+      {"DECODED",          list(submode.decoded)},
+      {"BP_DECODES",       submode.bpDecodes},
+      {"BP_ITERATIONS",    submode.bpIterations},
+      {"LAG_US",           list(submode.lag)},
+      {"WALL_US",          list(submode.wall)},
+      {"SYNC_US",          list(submode.stages[0])},
+      {"SELECT_US",        list(submode.stages[1])},
+      {"DOWNSAMPLE_US",    list(submode.stages[2])},
+      {"BPDECODE_US",      list(submode.stages[3])},
+      {"SUBTRACT_US",      list(submode.stages[4])}
+    };
+  }
+
+  QVariantMap result
+  {
+    {"INTERVAL_MS", static_cast<qint64>(std::chrono::duration_cast<std::chrono::milliseconds>(now - m_start).count())},
+    {"BUCKETS_US",  bounds},
+    {"SUBMODES",    submodes}
+  };
+
+  m_submodes.clear();
+  m_start = now;
+
+  return result;
+}
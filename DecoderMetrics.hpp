@@ -0,0 +1,64 @@
+#ifndef DECODER_METRICS_HPP__
+#define DECODER_METRICS_HPP__
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <QVariantMap>
+#include "JS8.hpp"
+
+// Aggregates the statistics that the decoder emits for each submode it
+// decodes over an interval, as counts and as histograms of durations, in
+// a form suitable for reporting as the parameters of a network message.
+//
+// Histogram buckets are powers of two in microseconds; bucket 0 counts
+// durations of less than a microsecond, bucket n those in [2^(n-1), 2^n),
+// and the last bucket anything longer. Recording is therefore a constant
+// time operation, and the size of a report is independent of the length
+// of the interval.
+
+class DecoderMetrics
+{
+public:
+
+  static constexpr std::size_t BUCKETS = 24;
+
+  using Histogram = std::array<qint64, BUCKETS>;
+
+  // Constructor; starts the first interval.
+
+  DecoderMetrics();
+
+  // Inline accessors
+
+  bool empty() const { return m_submodes.empty(); }
+
+  // Record the statistics for a decode.
+
+  void record(JS8::Event::Stats const &);
+
+  // Return the metrics recorded during the current interval, and start
+  // a new one.
+
+  QVariantMap take();
+
+private:
+
+  struct Submode
+  {
+    qint64                   decodes      = 0;
+    std::array<qint64, 3>    candidates   = {};
+    std::array<qint64, 3>    decoded      = {};
+    qint64                   bpDecodes    = 0;
+    qint64                   bpIterations = 0;
+    Histogram                lag          = {};
+    Histogram                wall         = {};
+    std::array<Histogram, 5> stages       = {};
+  };
+
+  std::chrono::steady_clock::time_point m_start;
+  std::map<int, Submode>                m_submodes;
+};
+
+#endif
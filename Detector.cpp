@@ -8,54 +8,22 @@
 #include "commons.h"
 #include "DriftingDateTime.h"
 
-/******************************************************************************/
-// FIR Filter Coefficients
-/******************************************************************************/
-
-namespace
-{
-  // Filter coefficients for an FIR lowpass filter designed using ScopeFIR.
-  //
-  //   fsample     = 48000 Hz
-  //   Ntaps       = 49
-  //   fc          = 4500  Hz
-  //   fstop       = 6000  Hz
-  //   Ripple      = 1     dB
-  //   Stop Atten  = 40    dB
-  //   fout        = 12000 Hz
-
-  constexpr std::array LOWPASS
-  {
-     0.000861074040f,  0.010051920210f,  0.010161983649f,  0.011363155076f,
-     0.008706594219f,  0.002613872664f, -0.005202883094f, -0.011720748164f,
-    -0.013752163325f, -0.009431602741f,  0.000539063909f,  0.012636767098f,
-     0.021494659597f,  0.021951235065f,  0.011564169382f, -0.007656470131f,
-    -0.028965787341f, -0.042637874109f, -0.039203309748f, -0.013153301537f,
-     0.034320769178f,  0.094717832646f,  0.154224604789f,  0.197758325022f,
-     0.213715139513f,  0.197758325022f,  0.154224604789f,  0.094717832646f,
-     0.034320769178f, -0.013153301537f, -0.039203309748f, -0.042637874109f,
-    -0.028965787341f, -0.007656470131f,  0.011564169382f,  0.021951235065f,
-     0.021494659597f,  0.012636767098f,  0.000539063909f, -0.009431602741f,
-    -0.013752163325f, -0.011720748164f, -0.005202883094f,  0.002613872664f,
-     0.008706594219f,  0.011363155076f,  0.010161983649f,  0.010051920210f,
-     0.000861074040f
-  };
-}
-
 /******************************************************************************/
 // Implementation
 /******************************************************************************/
 
 #include "moc_Detector.cpp"
 
-Detector::Detector(unsigned  frameRate,
-                   unsigned  periodLengthInSeconds,
-                   QObject * parent)
+Detector::Detector(dec_data & data,
+                   unsigned   frameRate,
+                   unsigned   periodLengthInSeconds,
+                   QObject  * parent)
   : AudioDevice (parent)
+  , m_decData   (data)
   , m_frameRate (frameRate)
   , m_period    (periodLengthInSeconds)
-  , m_filter    (LOWPASS)
 {
+  selectSampleRate(m_decimator.rate());
   clear();
 }
 
@@ -65,6 +33,29 @@ Detector::setBlockSize (unsigned n)
   m_samplesPerFFT = n;
 }
 
+// We'll take the device's preferred rate if we're able to decimate from
+// it, avoiding a trip through whatever resampler the system might use,
+// and otherwise fall back to 48kHz. Size the buffer to hold as many input
+// frames as are needed for the largest block at the selected rate.
+
+int
+Detector::selectSampleRate(int const preferred)
+{
+  QMutexLocker mutex(&m_lock);
+
+  auto const rate = preferred > 0 && Decimator::supports(preferred) ? static_cast<unsigned>(preferred)
+                                                                    : 48000u;
+  if (rate != m_decimator.rate())
+  {
+    m_decimator = Decimator(rate);
+  }
+
+  m_buffer.resize((MaxBufferSize * rate + Decimator::OUTPUT_RATE - 1) / Decimator::OUTPUT_RATE + 1);
+  m_bufferPos = 0;
+
+  return static_cast<int>(rate);
+}
+
 bool
 Detector::reset()
 {
@@ -81,12 +72,12 @@ Detector::clear()
   resetBufferPosition();
   resetBufferContent();
 #else
-  dec_data.params.kin = 0;
+  m_decData.params.kin = 0;
   m_bufferPos = 0;
 #endif
 
   // fill buffer with zeros (G4WJS commented out because it might cause decoder hangs)
-  // qFill (dec_data.d2, dec_data.d2 + sizeof (dec_data.d2) / sizeof (dec_data.d2[0]), 0);
+  // qFill (m_decData.d2, m_decData.d2 + sizeof (m_decData.d2) / sizeof (m_decData.d2[0]), 0);
 }
 
 void
@@ -97,37 +88,40 @@ Detector::resetBufferPosition()
   // set index to roughly where we are in time (1ms resolution)
   qint64   const now        = DriftingDateTime::currentMSecsSinceEpoch ();
   unsigned const msInPeriod = (now % 86400000LL) % (m_period * 1000);
-  int      const prevKin    = dec_data.params.kin;
+  int      const prevKin    = m_decData.params.kin;
 
-  dec_data.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])));
-  m_bufferPos         = 0;
-  m_ns                = secondInPeriod();
+  m_decData.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (m_decData.d2) / sizeof (m_decData.d2[0])));
+  m_bufferPos          = 0;
+  m_ns                 = secondInPeriod();
 
-  int const delta = dec_data.params.kin - prevKin;
+  int const delta = m_decData.params.kin - prevKin;
 
-  qDebug() << "advancing detector buffer from" << prevKin << "to" << dec_data.params.kin << "delta" << delta;
+  qDebug() << "advancing detector buffer from" << prevKin << "to" << m_decData.params.kin << "delta" << delta;
 
   // rotate buffer moving the contents that were at prevKin to the new kin position
+  dec_data_epoch_guard guard(m_decData);
+
   if (delta < 0)
   {
-    std::rotate(std::begin(dec_data.d2),
-                std::begin(dec_data.d2) - delta,
-                std::end  (dec_data.d2));
+    std::rotate(std::begin(m_decData.d2),
+                std::begin(m_decData.d2) - delta,
+                std::end  (m_decData.d2));
   }
   else
   {
-    std::rotate(std::rbegin(dec_data.d2),
-                std::rbegin(dec_data.d2) + delta,
-                std::rend  (dec_data.d2));
+    std::rotate(std::rbegin(m_decData.d2),
+                std::rbegin(m_decData.d2) + delta,
+                std::rend  (m_decData.d2));
   }
 }
 
 void
 Detector::resetBufferContent()
 {
-  QMutexLocker mutex(&m_lock);
+  QMutexLocker         mutex(&m_lock);
+  dec_data_epoch_guard guard(m_decData);
 
-  std::fill(std::begin(dec_data.d2), std::end(dec_data.d2), 0);
+  std::fill(std::begin(m_decData.d2), std::end(m_decData.d2), 0);
   qDebug() << "clearing detector buffer content";
 }
 
@@ -137,12 +131,15 @@ Detector::writeData(char const * const data,
 {
   QMutexLocker mutex(&m_lock);
 
-  // When ns has wrapped around to zero, restart the buffers.
+  // When ns has wrapped around to zero, restart the buffers. Appending
+  // from here on overwrites samples from the previous period, which the
+  // decoder must be able to tell apart from the ones they replace.
 
   int const ns = secondInPeriod();
   if(ns < m_ns) {
-    dec_data.params.kin = 0;
-    m_bufferPos         = 0;
+    dec_data_epoch_guard guard(m_decData);
+    m_decData.params.kin = 0;
+    m_bufferPos          = 0;
   }
   m_ns = ns;
 
@@ -152,21 +149,26 @@ Detector::writeData(char const * const data,
 
   // These are in terms of input frames (not down sampled).
 
-  size_t const framesAcceptable = (sizeof(dec_data.d2) / sizeof(dec_data.d2[0]) - dec_data.params.kin) * Filter::NDOWN;
+  size_t const framesAcceptable = m_decimator.needed(sizeof(m_decData.d2) / sizeof(m_decData.d2[0]) - m_decData.params.kin);
   size_t const framesAccepted   = qMin(static_cast<size_t>(maxSize /bytesPerFrame()), framesAcceptable);
 
   if (framesAccepted < static_cast<size_t>(maxSize / bytesPerFrame()))
   {
     qDebug() << "dropped " << maxSize / bytesPerFrame () - framesAccepted
               << " frames of data on the floor!"
-              << dec_data.params.kin
+              << m_decData.params.kin
               << ns;
   }
 
+  // Accumulate input frames until we've enough to produce a block, then
+  // decimate the block as a whole. If there's no room for the block, it's
+  // dropped without passing through the decimator, as if never received.
+
   for (auto remaining = framesAccepted;
                 remaining;)
   {
-    size_t const numFramesProcessed = qMin(m_samplesPerFFT * Filter::NDOWN - m_bufferPos, remaining);
+    size_t const framesPerBlock     = m_decimator.needed(m_samplesPerFFT);
+    size_t const numFramesProcessed = qMin(framesPerBlock - m_bufferPos, remaining);
 
     store (&data[(framesAccepted - remaining) * bytesPerFrame()],
            numFramesProcessed,
@@ -174,17 +176,16 @@ Detector::writeData(char const * const data,
 
     m_bufferPos += numFramesProcessed;
 
-    if (m_bufferPos == m_samplesPerFFT * Filter::NDOWN)
+    if (m_bufferPos == framesPerBlock)
     {
-      if (dec_data.params.kin >= 0 &&
-          dec_data.params.kin < static_cast<int>(JS8_NTMAX * 12000 - m_samplesPerFFT))
+      if (m_decData.params.kin >= 0 &&
+          m_decData.params.kin < static_cast<int>(JS8_NTMAX * 12000 - m_samplesPerFFT))
       {
-        for (std::size_t i = 0; i < m_samplesPerFFT; ++i)
-        {
-          dec_data.d2[dec_data.params.kin++] = m_filter.downSample(&m_buffer[i * Filter::NDOWN]);
-        }
+        m_decData.params.kin += m_decimator.process(m_buffer.data(),
+                                                    m_bufferPos,
+                                                    &m_decData.d2[m_decData.params.kin]);
       }
-      Q_EMIT framesWritten (dec_data.params.kin);
+      Q_EMIT framesWritten (m_decData.params.kin);
       m_bufferPos = 0;
     }
     remaining -= numFramesProcessed;
@@ -0,0 +1,284 @@
+#include "FFTW.hpp"
+#include <cassert>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/******************************************************************************/
+// Registry
+/******************************************************************************/
+
+namespace
+{
+  class Registry
+  {
+  public:
+
+    using Future  = std::shared_future<FFTW::Plan>;
+    using Promise = std::optional<std::promise<FFTW::Plan>>;
+
+    // Destructor; by the time we get here, nothing should be using any
+    // of the plans, but the warm-up thread might yet be running, in the
+    // unlikely event that we're exiting very early.
+
+    ~Registry() { cleanup(); }
+
+    // Look up the key, returning the future for its plan, along with a
+    // promise to fulfill if this is the first request for the key, in
+    // which case the caller is responsible for creating the plan.
+
+    std::pair<Future, Promise>
+    lookup(FFTW::Key const & key)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      if (auto const it  = m_plans.find(key);
+                     it != m_plans.end())
+      {
+        return {it->second, std::nullopt};
+      }
+
+      std::promise<FFTW::Plan> promise;
+      auto                     future = promise.get_future().share();
+
+      m_plans.emplace(key, future);
+
+      return {future, std::move(promise)};
+    }
+
+    // Create the plan for the key, fulfilling the promise with it, or
+    // with the exception that prevented its creation.
+
+    void
+    create(FFTW::Key          const & key,
+           std::promise<FFTW::Plan> & promise)
+    {
+      try
+      {
+        promise.set_value(FFTW::Plan(key, plan(key)));
+      }
+      catch (...)
+      {
+        promise.set_exception(std::current_exception());
+      }
+    }
+
+    // Start the warm-up thread, having first registered promises for all
+    // of the keys, such that anyone requesting one of them waits on the
+    // warm-up thread rather than creating it themselves.
+
+    void
+    start(std::string                    wisdom,
+          std::vector<FFTW::Key> const & keys)
+    {
+      if (m_thread.joinable()) m_thread.join();
+
+      std::vector<std::pair<FFTW::Key, std::promise<FFTW::Plan>>> pending;
+      std::promise<void>                                          imported;
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_imported = imported.get_future().share();
+      }
+
+      for (auto const & key : keys)
+      {
+        if (auto [future, promise] = lookup(key); promise)
+        {
+          pending.emplace_back(key, std::move(*promise));
+        }
+      }
+
+      m_thread = std::thread([this,
+                              wisdom   = std::move(wisdom),
+                              pending  = std::move(pending),
+                              imported = std::move(imported)]() mutable
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_planner);
+          fftwf_import_wisdom_from_filename(wisdom.c_str());
+        }
+
+        imported.set_value();
+
+        for (auto & [key, promise] : pending) create(key, promise);
+      });
+    }
+
+    // Wait for the warm-up thread, then export wisdom.
+
+    void
+    finish(char const * const wisdom)
+    {
+      if (m_thread.joinable()) m_thread.join();
+
+      std::lock_guard<std::mutex> lock(m_planner);
+      fftwf_export_wisdom_to_filename(wisdom);
+    }
+
+    // Destroy all plans, forget wisdom, and release everything FFTW has
+    // allocated. Nothing may be using any plan at this point.
+
+    void
+    cleanup()
+    {
+      if (m_thread.joinable()) m_thread.join();
+
+      std::lock_guard<std::mutex> registry(m_mutex);
+      std::lock_guard<std::mutex> planner(m_planner);
+
+      m_plans.clear();
+      m_imported = {};
+
+      for (auto const plan : m_created) fftwf_destroy_plan(plan);
+
+      m_created.clear();
+
+      fftwf_forget_wisdom();
+      fftwf_cleanup();
+    }
+
+  private:
+
+    // Create a plan for the key. We plan against scratch data having the
+    // requested alignment, so that we never disturb anyone's data; while
+    // the flags we use shouldn't cause the planner to overwrite the data,
+    // they're a choice, and this way we're free to change them.
+
+    fftwf_plan
+    plan(FFTW::Key const & key)
+    {
+      std::size_t const bytes = sizeof(fftwf_complex) * (key.size + 1) + key.alignment;
+
+      // If wisdom is in the process of being imported, let that finish
+      // before planning; no point in planning without it.
+
+      if (auto const imported = [this]()
+                                {
+                                  std::lock_guard<std::mutex> lock(m_mutex);
+                                  return m_imported;
+                                }(); imported.valid())
+      {
+        imported.wait();
+      }
+
+      std::lock_guard<std::mutex> lock(m_planner);
+
+      auto const memory = static_cast<char *>(fftwf_malloc(bytes));
+
+      if (!memory) throw std::runtime_error("Failed to allocate FFT data");
+
+      auto const data = reinterpret_cast<fftwf_complex *>(memory + key.alignment);
+      fftwf_plan plan = nullptr;
+
+      switch (key.kind)
+      {
+        case FFTW::Kind::R2C:
+          plan = fftwf_plan_dft_r2c_1d(key.size,
+                                       reinterpret_cast<float *>(data),
+                                       data,
+                                       FFTW_ESTIMATE_PATIENT);
+          break;
+
+        case FFTW::Kind::FORWARD:
+        case FFTW::Kind::BACKWARD:
+          plan = fftwf_plan_dft_1d(key.size,
+                                   data,
+                                   data,
+                                   key.kind == FFTW::Kind::FORWARD ? FFTW_FORWARD
+                                                                   : FFTW_BACKWARD,
+                                   FFTW_ESTIMATE_PATIENT);
+          break;
+      }
+
+      fftwf_free(memory);
+
+      if (!plan) throw std::runtime_error("Failed to create FFT plan");
+
+      m_created.push_back(plan);
+
+      return plan;
+    }
+
+    // Data members; the registry mutex guards the map and the import
+    // future, while the planner mutex serializes calls to FFTW other
+    // than plan execution.
+
+    std::mutex                  m_mutex;
+    std::mutex                  m_planner;
+    std::map<FFTW::Key, Future> m_plans;
+    std::shared_future<void>    m_imported;
+    std::vector<fftwf_plan>     m_created;
+    std::thread                 m_thread;
+  };
+
+  Registry &
+  registry()
+  {
+    static Registry registry;
+    return registry;
+  }
+}
+
+/******************************************************************************/
+// Public Interface
+/******************************************************************************/
+
+namespace FFTW
+{
+  void
+  Plan::execute(std::complex<float> * const data) const
+  {
+    assert(m_plan);
+    assert(fftwf_alignment_of(reinterpret_cast<float *>(data)) == m_key.alignment);
+
+    auto const complex = reinterpret_cast<fftwf_complex *>(data);
+
+    if (m_key.kind == Kind::R2C)
+    {
+      fftwf_execute_dft_r2c(m_plan, reinterpret_cast<float *>(complex), complex);
+    }
+    else
+    {
+      fftwf_execute_dft(m_plan, complex, complex);
+    }
+  }
+
+  Plan
+  plan(Key const & key)
+  {
+    auto [future, promise] = registry().lookup(key);
+
+    // If we were handed a promise, the plan is ours to create; otherwise,
+    // it's been created already, or someone else is on it.
+
+    if (promise) registry().create(key, *promise);
+
+    return future.get();
+  }
+
+  void
+  start(char const                * const wisdom,
+        std::initializer_list<Key> const  keys)
+  {
+    registry().start(wisdom, std::vector<Key>(keys));
+  }
+
+  void
+  finish(char const * const wisdom)
+  {
+    registry().finish(wisdom);
+  }
+
+  void
+  cleanup()
+  {
+    registry().cleanup();
+  }
+}
@@ -0,0 +1,87 @@
+#ifndef FFTW_HPP__
+#define FFTW_HPP__
+
+#include <complex>
+#include <initializer_list>
+#include <fftw3.h>
+
+// Registry of the FFTW plans used throughout the application.
+//
+// Other than plan execution, FFTW requires that all calls to it be
+// serialized, and planning is expensive, so we create each plan only
+// once, here, and share it. Plans are for in-place transforms, keyed
+// by the kind of transform, its size, and the alignment of the data,
+// and they're executed via the new-array interface; any data having
+// the alignment that the plan was created for may be used, from any
+// thread, at any time.
+//
+// Plans live until cleanup() at exit; nobody other than the registry
+// should ever destroy one.
+
+namespace FFTW
+{
+  enum class Kind
+  {
+    R2C,      // Real to complex
+    FORWARD,  // Complex to complex, forward
+    BACKWARD  // Complex to complex, backward
+  };
+
+  struct Key
+  {
+    Kind kind;
+    int  size;
+    int  alignment = 0;  // As reported by fftwf_alignment_of()
+
+    auto operator<=>(Key const &) const = default;
+  };
+
+  class Plan
+  {
+  public:
+
+    Plan() = default;
+    Plan(Key        const & key,
+         fftwf_plan const   plan)
+    : m_key (key)
+    , m_plan(plan)
+    {}
+
+    // Execute the plan in place on the supplied data, which must have
+    // the alignment the plan was created for. For a real to complex
+    // transform, the real input occupies the space of the output.
+
+    void execute(std::complex<float> * data) const;
+
+    explicit operator bool() const noexcept { return m_plan; }
+
+  private:
+
+    Key        m_key  = {};
+    fftwf_plan m_plan = nullptr;
+  };
+
+  // Returns the plan for the key, creating it if need be. If the plan
+  // is being created by another thread, including the warm-up thread,
+  // waits for it to be ready. Throws if the plan can't be created.
+
+  Plan plan(Key const &);
+
+  // Imports wisdom from the file, if it exists, and then creates plans
+  // for each of the keys, all on a background thread; returns at once.
+
+  void start(char const                * wisdom,
+             std::initializer_list<Key>  keys);
+
+  // Waits for anything started by start() to complete, then exports
+  // wisdom to the file.
+
+  void finish(char const * wisdom);
+
+  // Destroys all plans and releases all memory held by FFTW; call only
+  // at exit, once nothing can be using a plan.
+
+  void cleanup();
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -37,6 +38,14 @@ namespace
   constexpr auto FLATTEN_DEGREE =  5;
   constexpr auto FLATTEN_SAMPLE = 10;
 
+  // Tunable settings; the baseline changes slowly in comparison to the
+  // rate at which we're presented with spectra, so we refit it only at
+  // most every so many rows, or sooner if the level sampled at any node
+  // moves by more than the shift, in dB, from that of the current fit.
+
+  constexpr auto FLATTEN_REFIT  = 8;
+  constexpr auto FLATTEN_SHIFT  = 1.0f;
+
   // We're going to do a pairwise Estrin's evaluation of the polynomial
   // coefficients, so it's critical that the degree of the polynomial is
   // odd, resulting in an even number of coefficients.
@@ -44,6 +53,7 @@ namespace
   static_assert(FLATTEN_DEGREE &  1,   "Degree must be odd");
   static_assert(FLATTEN_SAMPLE >= 0 &&
                 FLATTEN_SAMPLE <= 100, "Sample must be a percentage");
+  static_assert(FLATTEN_REFIT  >  0,   "Refit interval must be positive");
 
   // Since we know the degree of the polynomial, and thus the number of
   // nodes that we're going to use, we can do all the trigonometry work
@@ -147,10 +157,15 @@ class Flatten::Impl
   using Vandermonde  = Eigen::Matrix<double, FLATTEN_NODES.size(),
                                              FLATTEN_NODES.size()>;
   using Coefficients = Eigen::Vector<double, FLATTEN_NODES.size()>;
+  using Levels       = std::array<float,     FLATTEN_NODES.size()>;
 
-  Points       p;
-  Vandermonde  V;
-  Coefficients c;
+  Points             p;
+  Vandermonde        V;
+  Coefficients       c;
+  Levels             levels = {};
+  std::vector<float> span;
+  std::vector<float> baseline;
+  int                rows   = 0;
 
   // Polynomial evaluation using Estrin's method, loop is unrolled at
   // compile time. A compiler should emit SIMD instructions from what
@@ -173,6 +188,23 @@ class Flatten::Impl
                                     Coefficients::SizeAtCompileTime / 2>{});
   }
 
+  // Determine if the baseline must be refit; that's the case if it's
+  // never been fit, if the size has changed, if we've reached the refit
+  // interval, or if the noise floor has shifted at any of the nodes.
+
+  bool
+  stale(std::size_t const size) const
+  {
+    if (baseline.size() != size || rows >= FLATTEN_REFIT) return true;
+
+    for (std::size_t i = 0; i < FLATTEN_NODES.size(); ++i)
+    {
+      if (std::fabs(p(i, 1) - levels[i]) > FLATTEN_SHIFT) return true;
+    }
+
+    return false;
+  }
+
 public:
 
   void
@@ -187,14 +219,17 @@ public:
     auto const arm = size / (2 * FLATTEN_NODES.size());
 
     // Collect lower envelope points; use Chebyshev node interpolants
-    // to reduce Runge's phenomenon oscillations.
+    // to reduce Runge's phenomenon oscillations. The span is scratch
+    // space, which we'll only need to allocate the first time through
+    // for a given size.
 
     for (std::size_t i = 0; i < FLATTEN_NODES.size(); ++i)
     {
       auto const node = size * FLATTEN_NODES[i];
       auto const base = data + static_cast<int>(std::round(node));
-      auto       span = std::vector<float>(std::clamp(base - arm, data, end),
-                                           std::clamp(base + arm, data, end));
+
+      span.assign(std::clamp(base - arm, data, end),
+                  std::clamp(base + arm, data, end));
 
       auto const n = span.size() * FLATTEN_SAMPLE / 100;
 
@@ -203,25 +238,40 @@ public:
       p.row(i) << node, span[n];
     }
 
-    // Extract x and y values from points and prepare the Vandermonde
-    // matrix, initializing the first column with 1 (x^0); remaining
-    // columns are filled with the Schur product.
-
-    Eigen::VectorXd x = p.col(0);
-    Eigen::VectorXd y = p.col(1);
+    // If the baseline we have is still good, just subtract it; that's
+    // the case for most rows.
 
-    V.col(0).setOnes();
-    for (Eigen::Index i = 1; i < V.cols(); ++i)
+    if (!stale(size))
     {
-      V.col(i) = V.col(i - 1).cwiseProduct(x);
+      ++rows;
     }
+    else
+    {
+      // Prepare the Vandermonde matrix, initializing the first column
+      // with 1 (x^0); remaining columns are filled with the Schur
+      // product.
+
+      V.col(0).setOnes();
+      for (Eigen::Index i = 1; i < V.cols(); ++i)
+      {
+        V.col(i) = V.col(i - 1).cwiseProduct(p.col(0));
+      }
+
+      // Solve the least squares problem for polynomial coefficients;
+      // evaluate the polynomial over the span to obtain the baseline,
+      // and note the levels that it was fit to.
+
+      c = V.colPivHouseholderQr().solve(p.col(1));
 
-    // Solve the least squares problem for polynomial coefficients;
-    // evaluate the polynomial and subtract the baseline.
+      baseline.resize(size);
 
-    c = V.colPivHouseholderQr().solve(y);
+      for (std::size_t i = 0; i < size; ++i) baseline[i] = evaluate(i);
+      for (std::size_t i = 0; i < FLATTEN_NODES.size(); ++i) levels[i] = p(i, 1);
+
+      rows = 1;
+    }
 
-    for (std::size_t i = 0; i < size; ++i) data[i] -= evaluate(i);
+    std::transform(data, end, baseline.begin(), data, std::minus<float>());
   }
 };
 
@@ -5,31 +5,36 @@
 #include "JS8.hpp"
 #include <algorithm>
 #include <atomic>
+#include <bitset>
+#include <chrono>
 #include <cmath>
 #include <complex>
 #include <concepts>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <latch>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include <boost/crc.hpp>
 #include <boost/math/ccmath/round.hpp>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/key.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/ranked_index.hpp>
-#include <fftw3.h>
 #include <vendor/Eigen/Dense>
 #include <QDebug>
+#include <QThreadPool>
 #include "commons.h"
+#include "FFTW.hpp"
+#ifdef JS8_TESTING
+#include "tests/JS8Testing.hpp"
+#endif
 
 // A C++ conversion of the Fortran JS8 encoding and decoder function.
 // Some notes on the conversion:
@@ -181,11 +186,13 @@ namespace
     constexpr int         NFSRCH   = 5;        // Search frequency range in Hz (i.e., +/- 2.5 Hz)
     constexpr std::size_t NMAXCAND = 300;      // Maxiumum number of candidate signals
     constexpr int         NFILT    = 1400;  // Filter length
+    constexpr int         NSUB     = 8192;  // Subtraction block length
     constexpr int         NROWS    = 8;
     constexpr int         NFOS     = 2;
     constexpr int         NSSY     = 4;
     constexpr int         NP       = 3200;
     constexpr int         NP2      = 2812;
+    constexpr int         NTILE    = 64;       // Frequency bins per sync search tile
     constexpr float       TAU      = 2.0f * M_PI;
     constexpr auto        ZERO     = std::complex<float>{0.0f, 0.0f};
 
@@ -488,7 +495,8 @@ namespace
         operator T() const { return m_sum; }
     };
 
-    // Management of dynamic FFTW plan storage.
+    // Plans used by a decoder, indexed by type; these are obtained from,
+    // and owned by, the FFTW plan registry.
 
     class FFTWPlanManager
     {
@@ -505,35 +513,9 @@ namespace
             count
         };
 
-        // Disallow copying and moving
-
-        FFTWPlanManager            (FFTWPlanManager const &) = delete;
-        FFTWPlanManager & operator=(FFTWPlanManager const &) = delete;
-        FFTWPlanManager            (FFTWPlanManager      &&) = delete;
-        FFTWPlanManager & operator=(FFTWPlanManager      &&) = delete;
-
-        // Constructor
-
-        FFTWPlanManager()
-        {
-            m_plans.fill(nullptr);
-        }
-
-        // Destructor
-
-        ~FFTWPlanManager()
-        {
-            std::lock_guard<std::mutex> lock(fftw_mutex);
-
-            for (auto & plan : m_plans)
-            {
-                if (plan) fftwf_destroy_plan(plan);
-            }
-        }
-
         // Accessor
 
-        fftwf_plan const &
+        FFTW::Plan const &
         operator[](Type const type) const noexcept
         {
             return m_plans[static_cast<std::size_t>(type)];
@@ -541,24 +523,17 @@ namespace
 
         // Manipulator
 
-        fftwf_plan &
+        FFTW::Plan &
         operator[](Type const type) noexcept
         {
             return m_plans[static_cast<std::size_t>(type)];
         }
 
-        // Iteration support
-
-        auto begin()       noexcept { return m_plans.begin(); }
-        auto end()         noexcept { return m_plans.end();   }
-        auto begin() const noexcept { return m_plans.begin(); }
-        auto end()   const noexcept { return m_plans.end();   }
-
     private:
 
         // Data members
 
-        std::array<fftwf_plan, static_cast<std::size_t>(Type::count)> m_plans;
+        std::array<FFTW::Plan, static_cast<std::size_t>(Type::count)> m_plans;
     };
 
     // Encapsulates the first-order search results provided by syncjs8().
@@ -580,40 +555,142 @@ namespace
         {}
     };
 
-    // Tag structs so that we can refer to multi index container indices
-    // by a descriptive tag instead of by the index of the index. These
-    // don't need to be anything but a name.
+    // Results of the sync search performed by syncjs8(), one entry for each
+    // frequency bin searched, in frequency order, held as a structure of
+    // arrays, along with scratch space used in selecting candidates from
+    // them. Capacity is retained across uses, so once the first decode has
+    // sized everything, nothing further is allocated.
 
-    namespace Tag
+    struct SyncBuffer
     {
-        struct Freq {};
-        struct Rank {};
-        struct Sync {};
-    }
+        std::vector<float>        freq;
+        std::vector<float>        step;
+        std::vector<float>        sync;
+        std::vector<float>        rank;
+        std::vector<std::size_t>  order;
+        std::vector<std::uint8_t> live;
+
+        bool        empty() const { return freq.empty(); }
+        std::size_t size()  const { return freq.size();  }
+
+        void
+        clear()
+        {
+            freq.clear();
+            step.clear();
+            sync.clear();
+        }
+
+        void
+        emplace(float const f,
+                float const t,
+                float const s)
+        {
+            freq.push_back(f);
+            step.push_back(t);
+            sync.push_back(s);
+        }
+
+        // Select candidates from the entries, normalizing their sync values
+        // in the process; near-duplicates are those within `az` Hz of one
+        // another in frequency.
+
+        std::vector<Sync>
+        candidates(float const az)
+        {
+            // Determine the 40th percentile. One thing to note here is that
+            // the Fortran version didn't seem to reliably calculate the 40th
+            // percentile rank; sometimes high, other times low, infrequently
+            // actually the 40th percentile value. This method should be
+            // perfectly accurate in all cases. Invalid values, should there
+            // be any, rank above all others.
+
+            rank.assign(sync.begin(), sync.end());
+
+            auto const nth = rank.begin() + size() * 4 / 10;
+
+            std::nth_element(rank.begin(),
+                             nth,
+                             rank.end(),
+                             [](float const a,
+                                float const b)
+                             {
+                               return a < b || (!std::isnan(a) && std::isnan(b));
+                             });
+
+            auto const normal = *nth;
+
+            // Order the entries that will be above the threshold once they're
+            // normalized by descending sync, and then by ascending frequency.
+            // Normalization is monotonic, but might make some distinct values
+            // equal, so we order by the values prior to normalization; that
+            // way, ties are broken as they'd have been before. Invalid values
+            // fail the threshold test, so there's nothing to be done there.
+
+            order.clear();
+
+            for (std::size_t i = 0; i < size(); ++i)
+            {
+                if (sync[i] / normal >= ASYNCMIN) order.push_back(i);
+            }
+
+            std::sort(order.begin(),
+                      order.end(),
+                      [&values = std::as_const(sync)](std::size_t const a,
+                                                      std::size_t const b)
+                      {
+                        return values[a] >  values[b] ||
+                              (values[a] == values[b] && a < b);
+                      });
+
+            // Normalize to the 40th percentile.
+
+            for (auto & value : sync) value /= normal;
+
+            // Extract candidates, strongest first; each one suppresses any
+            // near-duplicates based on frequency, which is to say that they
+            // won't become candidates themselves. Since entries are sorted
+            // by frequency, we find these by walking outward from the one
+            // we've taken until we're out of range on either side.
+
+            std::vector<Sync> candidates;
 
-    // Container indexing Sync objects in useful ways, used by syncjs8().
-
-    namespace MI    = boost::multi_index;
-    using SyncIndex = MI::multi_index_container
-    <
-        Sync,
-        MI::indexed_by
-        <
-            MI::ordered_non_unique<
-                MI::tag<Tag::Freq>,
-                MI::key<&Sync::freq>
-            >,
-            MI::ranked_non_unique<
-                MI::tag<Tag::Rank>,
-                MI::key<&Sync::sync>
-            >,
-            MI::ordered_non_unique<
-                MI::tag<Tag::Sync>,
-                MI::key<&Sync::sync>,
-                std::greater<>
-            >
-        >
-    >;
+            live.assign(size(), 1);
+
+            for (auto const i : order)
+            {
+                if (candidates.size() >= NMAXCAND) break;
+                if (!live[i])                      continue;
+
+                auto const f = freq[i];
+
+                candidates.emplace_back(f, step[i], sync[i]);
+
+                for (auto j = i;     j < size() && freq[j] <= f + az; ++j) live[j] = 0;
+                for (auto j = i; j-- > 0        && freq[j] >= f - az;)     live[j] = 0;
+            }
+
+            return candidates;
+        }
+    };
+
+    // Decoding is performed against a snapshot of the decode parameters,
+    // taken under the Detector mutex, along with the epoch of the sample
+    // buffer at that time. Samples themselves aren't copied; each mode
+    // reads just the window it needs directly from the sample buffer, and
+    // uses the epoch to determine if the samples were stable while doing
+    // so. The sample buffer is normally that of a receiver, but needn't be,
+    // e.g., when decoding recorded audio. The time at which the snapshot
+    // was taken is that at which the decode was requested.
+
+    struct Snapshot
+    {
+        decltype(dec_data::params)                      params;
+        std::uint32_t                                   epoch;
+        std::chrono::steady_clock::time_point           requested;
+        std::int16_t               const              * d2      = nullptr;
+        std::atomic<std::uint32_t> const              * d2epoch = nullptr;
+    };
 
     // Represents a decoded message, i.e., the 3-bit message type
     // and the 12 bytes that result from decoding a message.
@@ -657,6 +734,17 @@ namespace
     constexpr int BP_MAX_ROWS       = 7;  // Max rows per column in Nm
     constexpr int BP_MAX_CHECKS     = 3;  // Max checks per bit in Mn
     constexpr int BP_MAX_ITERATIONS = 30; // Max iterations in BP decoder
+    constexpr float BP_MINSUM_SCALE = 0.75f; // Normalization of min-sum check messages
+
+    // Check node update rule; the sum-product rule is the classic one, the
+    // min-sum rule approximates it without any transcendental functions, in
+    // return for a small loss in sensitivity.
+
+    enum class BPAlgorithm
+    {
+        SumProduct,
+        MinSum
+    };
 
     constexpr std::array<std::array<int, BP_MAX_CHECKS>, N> Mn =
     {{
@@ -731,74 +819,115 @@ namespace
     }};
 
     // Belief Propagation Decoder
-
-    int
-    bpdecode174(std::array<float, N> const & llr,
-                std::array<int8_t, K>      & decoded,
-                std::array<int8_t, N>      & cw)
+    //
+    // Decodes a batch of codewords in lock-step. Messages are laid out with
+    // the codeword innermost, so that each step of the algorithm is a loop
+    // across the batch that the compiler can vectorize. Every codeword sees
+    // exactly the sequence of operations that it would if decoded by itself,
+    // and we stop looking at it as soon as it's decoded, or it's clear that
+    // it's not going to be; we're done when that's true of all of them.
+    //
+    // Returns, for each codeword, the number of hard errors if decoded, or
+    // -1 if not; for the latter, `cw` contains the hard decisions as of the
+    // iteration on which we gave up. If provided, the number of iterations
+    // performed is added to `iterations`.
+
+    template <std::size_t Lanes>
+    std::array<int, Lanes>
+    bpdecode174(std::array<std::array<float,  N>, Lanes> const & llr,
+                std::array<std::array<int8_t, K>, Lanes>       & decoded,
+                std::array<std::array<int8_t, N>, Lanes>       & cw,
+                BPAlgorithm                              const   algorithm  = BPAlgorithm::SumProduct,
+                int                                            * iterations = nullptr)
     {
+        using Batch = std::array<float, Lanes>;
+
         // Initialize messages and variables
-        std::array<std::array<float, BP_MAX_CHECKS>, N> tov     = {}; // Messages to variable nodes
-        std::array<std::array<float, BP_MAX_ROWS>,   M> toc     = {}; // Messages to check nodes
-        std::array<std::array<float, BP_MAX_ROWS>  , M> tanhtoc = {}; // Tanh of messages
+        std::array<std::array<Batch, BP_MAX_CHECKS>, N> tov     = {}; // Messages to variable nodes
+        std::array<std::array<Batch, BP_MAX_ROWS>,   M> toc     = {}; // Messages to check nodes
+        std::array<std::array<Batch, BP_MAX_ROWS>,   M> tanhtoc = {}; // Tanh of messages
+
+        std::array<Batch, N> lr; // Channel log likelihood ratios
+        std::array<Batch, N> zn; // Bit log likelihood ratios
 
-        std::array<float, N> zn   = {}; // Bit log likelihood ratios
-        std::array<int,   M> synd = {}; // Syndrome for checks
+        std::array<int,  Lanes> nerr;
+        std::array<int,  Lanes> ncnt   = {};
+        std::array<int,  Lanes> nclast = {};
+        std::array<bool, Lanes> active;
+        std::size_t             remaining = Lanes;
 
-        int ncnt   = 0;
-        int nclast = 0;
+        nerr.fill(-1);
+        active.fill(true);
+
+        for (int i = 0; i < N; ++i) {
+            for (std::size_t l = 0; l < Lanes; ++l) lr[i][l] = llr[l][i];
+        }
 
         // Initialize toc (messages from bits to checks)
         for (int i = 0; i < M; ++i) {
             for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
-                toc[i][j] = llr[Nm[i].neighbors[j]];
+                toc[i][j] = lr[Nm[i].neighbors[j]];
             }
         }
 
         // Iterative decoding
         for (int iter = 0; iter <= BP_MAX_ITERATIONS; ++iter) {
+            if (iterations) ++*iterations;
+
             // Update bit log likelihood ratios
             for (int i = 0; i < N; ++i) {
-                zn[i] = llr[i] + std::accumulate(tov[i].begin(), tov[i].begin() + BP_MAX_CHECKS, 0.0f);
-            }
-
-            // Check if we have a valid codeword
-            for (int i = 0; i < N; ++i) cw[i] = zn[i] > 0 ? 1 : 0;
-
-            int ncheck = 0;
-            for (int i = 0; i < M; ++i) {
-                synd[i] = 0;
-                for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
-                    synd[i] += cw[Nm[i].neighbors[j]];
+                for (std::size_t l = 0; l < Lanes; ++l) {
+                    zn[i][l] = lr[i][l] + (((0.0f + tov[i][0][l]) + tov[i][1][l]) + tov[i][2][l]);
                 }
-                if (synd[i] % 2 != 0) ++ncheck;
             }
 
-            if (ncheck == 0)
-            {
-                // Extract decoded bits (last N-M bits of codeword)
-                std::copy(cw.begin() + M, cw.end(), decoded.begin());
+            for (std::size_t l = 0; l < Lanes; ++l) {
+                if (!active[l]) continue;
 
-                // Count errors
-                int nerr = 0;
-                for (int i = 0; i < N; ++i) {
-                    if ((2 * cw[i] - 1) * llr[i] < 0.0f) {
-                        ++nerr;
+                // Check if we have a valid codeword
+                for (int i = 0; i < N; ++i) cw[l][i] = zn[i][l] > 0 ? 1 : 0;
+
+                int ncheck = 0;
+                for (int i = 0; i < M; ++i) {
+                    int synd = 0;
+                    for (int j = 0; j < Nm[i].valid_neighbors; ++j) {
+                        synd += cw[l][Nm[i].neighbors[j]];
                     }
+                    if (synd % 2 != 0) ++ncheck;
                 }
 
-                return nerr;
-            }
+                if (ncheck == 0)
+                {
+                    // Extract decoded bits (last N-M bits of codeword)
+                    std::copy(cw[l].begin() + M, cw[l].end(), decoded[l].begin());
+
+                    // Count errors
+                    nerr[l] = 0;
+                    for (int i = 0; i < N; ++i) {
+                        if ((2 * cw[l][i] - 1) * llr[l][i] < 0.0f) {
+                            ++nerr[l];
+                        }
+                    }
 
-            // Early stopping criterion
-            if (iter > 0) {
-                int nd = ncheck - nclast;
-                ncnt = (nd < 0) ? 0 : ncnt + 1;
-                if (ncnt >= 5 && iter >= 10 && ncheck > 15) {
-                    return -1;
+                    active[l] = false;
+                    --remaining;
+                    continue;
                 }
+
+                // Early stopping criterion
+                if (iter > 0) {
+                    int nd = ncheck - nclast[l];
+                    ncnt[l] = (nd < 0) ? 0 : ncnt[l] + 1;
+                    if (ncnt[l] >= 5 && iter >= 10 && ncheck > 15) {
+                        active[l] = false;
+                        --remaining;
+                        continue;
+                    }
+                }
+                nclast[l] = ncheck;
             }
-            nclast = ncheck;
+
+            if (remaining == 0) break;
 
             // Send messages from bits to check nodes
             for (int i = 0; i < M; ++i) {
@@ -807,36 +936,69 @@ namespace
                     toc[i][j] = zn[ibj];
                     for (int k = 0; k < BP_MAX_CHECKS; ++k) {
                         if (Mn[ibj][k] == i) {
-                            toc[i][j] -= tov[ibj][k];
+                            for (std::size_t l = 0; l < Lanes; ++l) toc[i][j][l] -= tov[ibj][k][l];
                         }
                     }
                 }
             }
 
-            // Send messages from check nodes to variable nodes
-            for (int i = 0; i < M; ++i) {
-                for (int j = 0; j < 7; ++j) { // Fixed range [0, 7) to match Fortran's 1:7, could be nrw[j], or 7 logically
-                    tanhtoc[i][j] = std::tanh(-toc[i][j] / 2.0f);
+            // Send messages from check nodes to variable nodes; for min-sum,
+            // the magnitude is the smallest of the other incoming magnitudes,
+            // scaled, and the sign is that the sum-product rule would yield.
+            if (algorithm == BPAlgorithm::MinSum) {
+                for (int i = 0; i < N; ++i) {
+                    for (int j = 0; j < BP_MAX_CHECKS; ++j) {
+                        int ichk = Mn[i][j];
+                        if (ichk >= 0) {
+                            Batch mag;
+                            Batch sgn;
+                            mag.fill(std::numeric_limits<float>::infinity());
+                            sgn.fill(-BP_MINSUM_SCALE);
+                            for (int k = 0; k < Nm[ichk].valid_neighbors; ++k) {
+                                if (Nm[ichk].neighbors[k] != i) {
+                                    for (std::size_t l = 0; l < Lanes; ++l) {
+                                        auto const x = toc[ichk][k][l];
+                                        mag[l] = std::min(mag[l], std::abs(x));
+                                        sgn[l] = x > 0.0f ? -sgn[l] : sgn[l];
+                                    }
+                                }
+                            }
+                            for (std::size_t l = 0; l < Lanes; ++l) {
+                                tov[i][j][l] = sgn[l] * mag[l];
+                            }
+                        }
+                    }
+                }
+            } else {
+                for (int i = 0; i < M; ++i) {
+                    for (int j = 0; j < 7; ++j) { // Fixed range [0, 7) to match Fortran's 1:7, could be nrw[j], or 7 logically
+                        for (std::size_t l = 0; l < Lanes; ++l) {
+                            tanhtoc[i][j][l] = std::tanh(-toc[i][j][l] / 2.0f);
+                        }
+                    }
                 }
-            }
 
-            for (int i = 0; i < N; ++i) {
-                for (int j = 0; j < BP_MAX_CHECKS; ++j) {
-                    int ichk = Mn[i][j];
-                    if (ichk >= 0) {
-                        float Tmn = 1.0f;
-                        for (int k = 0; k < Nm[ichk].valid_neighbors; ++k) {
-                            if (Nm[ichk].neighbors[k] != i) {
-                                Tmn *= tanhtoc[ichk][k];
+                for (int i = 0; i < N; ++i) {
+                    for (int j = 0; j < BP_MAX_CHECKS; ++j) {
+                        int ichk = Mn[i][j];
+                        if (ichk >= 0) {
+                            Batch Tmn;
+                            Tmn.fill(1.0f);
+                            for (int k = 0; k < Nm[ichk].valid_neighbors; ++k) {
+                                if (Nm[ichk].neighbors[k] != i) {
+                                    for (std::size_t l = 0; l < Lanes; ++l) Tmn[l] *= tanhtoc[ichk][k][l];
+                                }
+                            }
+                            for (std::size_t l = 0; l < Lanes; ++l) {
+                                tov[i][j][l] = 2.0f * std::atanh(-Tmn[l]);
                             }
                         }
-                        tov[i][j] = 2.0f * std::atanh(-Tmn);
                     }
                 }
             }
         }
 
-        return -1; // Decoding failed
+        return nerr;
     }
 }
 
@@ -1069,6 +1231,88 @@ namespace
 
 namespace
 {
+    // Taps of the low pass filter used during signal subtraction; a Hann-like
+    // window of NFILT + 1 taps, normalized, and rotated as the Fortran version
+    // did. The rotation is within the taps, so they lie at delays 0 through
+    // NFILT, i.e., the filter is causal. Written to the first NFILT + 1 of the
+    // elements provided; computed Pi to match the Fortran version.
+
+    void
+    subtractionTaps(std::complex<float> * const taps)
+    {
+        float const pi  = 4.0f * std::atan(1.0f);
+        float       sum = 0.0f;
+
+        for (int j = -NFILT / 2; j <= NFILT / 2; ++j)
+        {
+            int   const index = j + NFILT / 2;
+            float const value = std::pow(std::cos(pi * j / NFILT), 2);
+
+            taps[index] = value;
+            sum        += value;
+        }
+
+        for (int i = 0; i <= NFILT; ++i) taps[i] /= sum;
+
+        std::rotate(taps,
+                    taps + NFILT / 2,
+                    taps + NFILT + 1);
+    }
+
+    // Frequency domain representation of the subtraction filter, normalized
+    // for use with the unnormalized inverse transform of an NSUB-point block.
+    // This is the same for all modes, so it's computed only once.
+
+    auto const &
+    subtractionFilter()
+    {
+        static auto const filter = []()
+        {
+            alignas(64) std::array<std::complex<float>, NSUB> filter = {};
+
+            subtractionTaps(filter.data());
+
+            // Transform the filter into the frequency domain.
+
+            FFTW::plan({FFTW::Kind::FORWARD, NSUB}).execute(filter.data());
+
+            // Normalize the frequency domain representation.
+
+            for (auto & value : filter) value *= 1.0f / NSUB;
+
+            return filter;
+        }();
+
+        return filter;
+    }
+
+    // Adds the time spent within its scope to a counter, if it's handed
+    // one; if not, it doesn't so much as look at the clock.
+
+    class ScopedTimer
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::atomic<std::int64_t> * m_counter;
+        Clock::time_point           m_start;
+
+    public:
+
+        explicit ScopedTimer(std::atomic<std::int64_t> * const counter)
+        : m_counter(counter)
+        , m_start  (counter ? Clock::now() : Clock::time_point())
+        {}
+
+        ~ScopedTimer()
+        {
+            if (m_counter) m_counter->fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count(),
+                                                std::memory_order_relaxed);
+        }
+
+        ScopedTimer(ScopedTimer const &)             = delete;
+        ScopedTimer & operator=(ScopedTimer const &) = delete;
+    };
+
     template <typename Mode>
     class DecodeMode
     {
@@ -1076,20 +1320,121 @@ namespace
 
         std::array<float, Mode::NFFT1>                                                nuttal;
         std::array<std::array<std::array<std::complex<float>, Mode::NDOWNSPS>, 7>, 3> csyncs;
-        alignas(64) std::array<std::complex<float>, Mode::NDOWNSPS>                   csymb;
-        alignas(64) std::array<std::complex<float>, Mode::NMAX>                       filter;
-        alignas(64) std::array<std::complex<float>, Mode::NMAX>                       cfilt;
+        alignas(64) std::array<std::complex<float>, NN * Mode::NSPS>                  cref;
+        alignas(64) std::array<std::complex<float>, NSUB>                             csub;
         alignas(64) std::array<std::complex<float>, Mode::NDFFT1 / 2 + 1>             ds_cx;
         alignas(64) std::array<std::complex<float>, Mode::NFFT1  / 2 + 1>             sd;
-        alignas(64) std::array<std::complex<float>, NP>                               cd0;
         std::array<float, Mode::NMAX>                                                 dd;
-        std::array<std::array<float, Mode::NHSYM>, Mode::NSPS>                        s;
+        std::array<std::array<float, Mode::NSPS>, Mode::NHSYM>                        s;
         std::array<float, Mode::NSPS>                                                 savg;
         FFTWPlanManager                                                               plans;
-        SyncIndex                                                                     sync;
+        SyncBuffer                                                                    sync;
 
         using Plan = FFTWPlanManager::Type;
 
+        // Number of symbol spectra columns that fit within the input wave;
+        // the last few of the NHSYM columns never do, and remain zero.
+
+        static constexpr int NCOLS = std::min(Mode::NHSYM, (Mode::NMAX - Mode::NFFT1) / Mode::NSTEP + 1);
+
+        // Symbol spectra from the first pass of the most recent decode, along
+        // with the window of the sample buffer they were computed from. Most
+        // decodes are of a window that overlaps the prior one, either growing
+        // from the same start as the cycle fills, or sliding along behind the
+        // write position when decoding every second. The spectra of symbols
+        // lying entirely within both windows are identical, so we can copy
+        // those instead of recomputing them.
+
+        struct
+        {
+            std::array<std::array<float, Mode::NSPS>, Mode::NHSYM> s;
+            std::optional<std::uint32_t>                           epoch;
+            int                                                    pos = 0;
+            int                                                    sz  = 0;
+        } spectra;
+
+        // Columns of the symbol spectra that no longer reflect the content
+        // of `dd`, and must be recomputed by the next sync. Every column is
+        // dirty when a decode starts, less any we're able to restore, and a
+        // subtraction dirties only the columns overlapping the signal; later
+        // passes then recompute only those.
+
+        std::bitset<NCOLS> dirty;
+
+        // Candidates found by early decoding in a partially filled window,
+        // whose frames had yet to arrive in full, along with the window they
+        // were found in. They're carried forward to the next decode of the
+        // same window, and decoded once the window contains all of them.
+
+        struct
+        {
+            std::optional<std::uint32_t> epoch;
+            int                          pos = 0;
+            std::vector<Sync>            candidates;
+        } early;
+
+        // Scratch space used while decoding a single candidate. Everything
+        // js8dec() writes to lives here, along with the plans that operate
+        // on it, so that candidates can be decoded concurrently; each thread
+        // decoding candidates must have a scratch space of its own. Plans
+        // come from the registry, so they're shared by all scratch spaces.
+
+        struct Scratch
+        {
+            alignas(64) std::array<std::complex<float>, Mode::NDOWNSPS> csymb = {};
+            alignas(64) std::array<std::complex<float>, NP>             cd0   = {};
+            FFTWPlanManager                                             plans;
+
+            Scratch()
+            {
+                plans[Plan::DS] = FFTW::plan({FFTW::Kind::BACKWARD, Mode::NDFFT2});
+                plans[Plan::CS] = FFTW::plan({FFTW::Kind::FORWARD,  Mode::NDOWNSPS});
+            }
+        };
+
+        // Results of decoding a single candidate; events that occurred
+        // during the decode are held here until the candidate is merged,
+        // in order, at the end of a pass.
+
+        struct Result
+        {
+            std::vector<JS8::Event::Variant> events;
+            std::optional<Decode>            decode;
+            std::array<int, NN>              itone;
+            float                            f1;
+            float                            xdt;
+            float                            xsnr;
+            int                              nharderrors;
+        };
+
+        std::vector<std::unique_ptr<Scratch>> scratchSpaces;
+
+        // Time spent in each pass, and in each stage of decoding, during the
+        // current decode, in nanoseconds, along with counts of the work done;
+        // accumulated only if the caller has asked for timings or stats.
+        // Candidates may be decoded concurrently, so the counters they touch
+        // must be atomic.
+
+        enum class Stage { SYNC, CANDIDATES, DOWNSAMPLE, BPDECODE, SUBTRACT, count };
+
+        struct
+        {
+            bool                                                                        enabled      = false;
+            std::array<std::atomic<std::int64_t>, 3>                                    passes       = {};
+            std::array<std::atomic<std::int64_t>, static_cast<std::size_t>(Stage::count)> stages       = {};
+            std::array<int, 3>                                                          candidates   = {};
+            std::array<int, 3>                                                          decoded      = {};
+            std::atomic<int>                                                            bpDecodes    = 0;
+            std::atomic<int>                                                            bpCodewords  = 0;
+            std::atomic<int>                                                            bpIterations = 0;
+        } timing;
+
+        std::atomic<std::int64_t> *
+        timer(Stage const stage)
+        {
+            return timing.enabled ? &timing.stages[static_cast<std::size_t>(stage)] : nullptr;
+        }
+
         static constexpr auto Costas = JS8::Costas::array(Mode::NCOSTAS);
 
         // Fore and aft tapers to reduce spectral leakage during the
@@ -1110,46 +1455,75 @@ namespace
             return taper;
         }();
 
-        // Baseline computation support.
+        // Baseline computation support. The polynomial is always fit at the
+        // same points, i.e., the Chebyshev nodes scaled to the window of bins
+        // used for baseline determination, so the Vandermonde matrix is a
+        // constant for the mode, and we need only factor it once. Mapping
+        // the bins in the [ia, ib] range onto the polynomial's domain is a
+        // constant for the range, which in practice changes only when the
+        // filter does, so we retain the powers of the mapped values, the
+        // basis, for as long as the range is unchanged; the baseline is then
+        // simply the product of the basis and the polynomial coefficients.
+
+        static constexpr auto BASELINE_BMIN = static_cast<std::size_t>(boost::math::ccmath::round(BASELINE_MIN / Mode::DF));
+        static constexpr auto BASELINE_BMAX = static_cast<std::size_t>(boost::math::ccmath::round(BASELINE_MAX / Mode::DF));
+        static constexpr auto BASELINE_SIZE = BASELINE_BMAX - BASELINE_BMIN + 1;
+        static constexpr auto BASELINE_ARM  = BASELINE_SIZE / (2 * BASELINE_NODES.size());
 
-        using Points       = Eigen::Matrix<double, BASELINE_NODES.size(), 2>;
         using Vandermonde  = Eigen::Matrix<double, BASELINE_NODES.size(),
                                                    BASELINE_NODES.size()>;
         using Coefficients = Eigen::Vector<double, BASELINE_NODES.size()>;
+        using Basis        = Eigen::Matrix<double, Eigen::Dynamic,
+                                                   BASELINE_NODES.size()>;
+        using Solver       = Eigen::ColPivHouseholderQR<Vandermonde>;
 
-        Points       p;
-        Vandermonde  V;
-        Coefficients c;
-
-        // Polynomial evaluation using Estrin's method, loop is unrolled at
-        // compile time. A compiler should emit SIMD instructions from what
-        // it sees here when the optimizer is involved, but even without it,
-        // we'll likely see fused multiply-add instructions.
-
-        inline auto
-        evaluate(float const x) const
+        struct
         {
-            return [this]<Eigen::Index... I>(float const x,
-                                             std::integer_sequence<Eigen::Index, I...>)
+            Basis           basis;
+            Eigen::VectorXd values;
+            int             ia = 0;
+            int             ib = -1;
+        } baseline;
+
+        // Factorization of the Vandermonde matrix, initializing the first
+        // column with 1 (x^0); remaining columns are filled with the Schur
+        // product.
+
+        static Solver const &
+        baselineSolver()
+        {
+            static Solver const solver = []
             {
-                auto baseline = 0.0;
-                auto exponent = 1.0;
+                Coefficients x;
+                Vandermonde  V;
+
+                for (std::size_t i = 0; i < BASELINE_NODES.size(); ++i)
+                {
+                    x[i] = BASELINE_SIZE * BASELINE_NODES[i];
+                }
+
+                V.col(0).setOnes();
+                for (Eigen::Index i = 1; i < V.cols(); ++i)
+                {
+                    V.col(i) = V.col(i - 1).cwiseProduct(x);
+                }
 
-                ((baseline += (c[I * 2] + c[I * 2 + 1] * x) * exponent, exponent *= x * x), ...);
+                return Solver(V);
+            }();
 
-                return static_cast<float>(baseline);
-            }(x, std::make_integer_sequence<Eigen::Index,
-                                            Coefficients::SizeAtCompileTime / 2>{});
+            return solver;
         }
 
         std::optional<Decode>
-        js8dec(bool          const syncStats,
-               bool          const lsubtract,
-               float             & f1,
-               float             & xdt,
-               int               & nharderrors,
-               float             & xsnr,
-               JS8::Event::Emitter emitEvent)
+        js8dec(Scratch             & scratch,
+               bool          const   syncStats,
+               BPAlgorithm   const   algorithm,
+               float               & f1,
+               float               & xdt,
+               int                 & nharderrors,
+               float               & xsnr,
+               std::array<int, NN> & itone,
+               JS8::Event::Emitter   emitEvent)
         {
             constexpr float FR  = 12000.0f / Mode::NFFT1;  // Frequency resolution
             constexpr float FS2 = 12000.0f / Mode::NDOWN;
@@ -1164,7 +1538,7 @@ namespace
 
             // Downsample the signal and prepare for processing.
 
-            js8_downsample(f1);
+            js8_downsample(scratch, f1);
 
             // Initial guess for the start of the signal.
 
@@ -1177,7 +1551,7 @@ namespace
                      idt <= i0 + Mode::NQSYMBOL;
                    ++idt)
             {
-                float const sync = syncjs8d(idt, 0.0f);
+                float const sync = syncjs8d(scratch, idt, 0.0f);
 
                 if (sync > smax) {
                     smax = sync;
@@ -1199,7 +1573,7 @@ namespace
                    ++ifr)
             {
                 float const delf = ifr * 0.5f;
-                float const sync = syncjs8d(i0, delf);
+                float const sync = syncjs8d(scratch, i0, delf);
 
                 if (sync > smax) {
                     smax     = sync;
@@ -1215,8 +1589,8 @@ namespace
         
             for (int i = 0; i < NP2; ++i)
             {
-                w      *= wstep; // Update cumulative phase
-                cd0[i] *= w;     // Apply phase shift
+                w              *= wstep; // Update cumulative phase
+                scratch.cd0[i] *= w;     // Apply phase shift
             }
 
             // Adjust the frequency and time offset.
@@ -1224,7 +1598,7 @@ namespace
             xdt = xdt2;
             f1 += delfbest;
 
-            float const sync = syncjs8d(i0, 0.0f);
+            float const sync = syncjs8d(scratch, i0, 0.0f);
 
             std::array<std::array<float, NN>, NROWS> s2;
 
@@ -1234,22 +1608,22 @@ namespace
 
                 int const i1 = ibest + k * Mode::NDOWNSPS;
 
-                csymb.fill(ZERO);
+                scratch.csymb.fill(ZERO);
 
                 if (i1 >= 0 && i1 + Mode::NDOWNSPS <= NP2)
                 {
-                    std::copy(cd0.begin() + i1,
-                              cd0.begin() + i1 + Mode::NDOWNSPS,
-                              csymb.begin());
+                    std::copy(scratch.cd0.begin() + i1,
+                              scratch.cd0.begin() + i1 + Mode::NDOWNSPS,
+                              scratch.csymb.begin());
                 }
 
-                fftwf_execute(plans[Plan::CS]);
+                scratch.plans[Plan::CS].execute(scratch.csymb.data());
 
                 // Normalize and take the magnitude of the first 8 points.
 
                 for (int i = 0; i < NROWS; ++i)
                 {
-                    s2[i][k] = std::abs(csymb[i]) / 1000.0f;
+                    s2[i][k] = std::abs(scratch.csymb[i]) / 1000.0f;
                 }
             }
 
@@ -1357,25 +1731,43 @@ namespace
             normalizeLLR(llr0);
             normalizeLLR(llr1);
 
-            std::array<int8_t, K> decoded;
-            std::array<int8_t, N> cw;
+            // Decoding passes 1, 3, and 4 use LLR 0, and pass 2 uses LLR 1;
+            // pass 3 zeros the first 24 bits of LLR 0, and pass 4 zeros the
+            // first 48 bits. The passes don't depend on one another, and most
+            // candidates don't decode at all, making it through every pass,
+            // so we decode all four of them in one batch, then consider the
+            // results in pass order.
 
-            // Loop over decoding passes
-            for (int ipass = 1; ipass <= 4; ++ipass)
+            std::array<std::array<float,  N>, 4> llrs = {llr0, llr1, llr0, llr0};
+            std::array<std::array<int8_t, K>, 4> decodes;
+            std::array<std::array<int8_t, N>, 4> cws;
+
+            std::fill(llrs[2].begin(), llrs[2].begin() + 24, 0.0f);
+            std::fill(llrs[3].begin(), llrs[3].begin() + 48, 0.0f);
+
+            auto const nerrs = [&]()
             {
-                // LLR 0 used on passes 1, 3, and 4; LLR 1 used on pass 2.
+                ScopedTimer const scopedTimer(timer(Stage::BPDECODE));
+
+                if (!timing.enabled) return bpdecode174(llrs, decodes, cws, algorithm);
 
-                auto const & llr = ipass == 2 ? llr1 : llr0;
+                int  iterations = 0;
+                auto nerrs      = bpdecode174(llrs, decodes, cws, algorithm, &iterations);
 
-                // Zero the first 24 bytes of LLR 0 on the third pass;
-                // the first 48 bytes of LLR 0 on the fourth pass;
+                timing.bpDecodes   .fetch_add(1,           std::memory_order_relaxed);
+                timing.bpCodewords .fetch_add(llrs.size(), std::memory_order_relaxed);
+                timing.bpIterations.fetch_add(iterations,  std::memory_order_relaxed);
 
-                if      (ipass == 3) std::fill(llr0.begin(),      llr0.begin() + 24, 0.0f);
-                else if (ipass == 4) std::fill(llr0.begin() + 24, llr0.begin() + 48, 0.0f);
+                return nerrs;
+            }();
 
-                // Decode using belief propagation.
+            // Loop over decoding passes
+            for (int ipass = 1; ipass <= 4; ++ipass)
+            {
+                auto const & decoded = decodes[ipass - 1];
+                auto const & cw      = cws[ipass - 1];
 
-                nharderrors = bpdecode174(llr, decoded, cw);
+                nharderrors = nerrs[ipass - 1];
                 xsnr        = -99.0f;
 
                 // Check for all-zero codeword
@@ -1403,14 +1795,8 @@ namespace
                                           (decoded[73] << 1) |
                                            decoded[74];
 
-                        std::array<int, NN> itone;
-
                         JS8::encode(i3bit, Costas, message.data(), itone.data());
 
-                        // Subtract signal if needed.
-
-                        if (lsubtract) subtractjs8(genjs8refsig(itone, f1), xdt2);
-
                         // Compute the signal power.
 
                         float xsig = 0.0f;
@@ -1467,23 +1853,12 @@ namespace
         baselinejs8(int const ia,
                     int const ib)
         {
-            // Data referenced in savg is defined by the closed range [bmin, bmax].
-            // From this we can derive the size of the closed range and the number
-            // of points in each of the arms on either side of a node. All of these
-            // values can be computed at compile time.
-
-            using boost::math::ccmath::round;
-
-            constexpr auto bmin = static_cast<std::size_t>(round(BASELINE_MIN / Mode::DF));
-            constexpr auto bmax = static_cast<std::size_t>(round(BASELINE_MAX / Mode::DF));
-            constexpr auto size = bmax - bmin + 1;
-            constexpr auto arm  = size / (2 * BASELINE_NODES.size());
-
             // Loop invariants; beginning of the data range, sentinel one past the
-            // end of the range.
+            // end of the range. Data referenced in savg is defined by the closed
+            // range [BASELINE_BMIN, BASELINE_BMAX].
 
-            auto const data = savg.begin() + bmin;
-            auto const end  = data + size;
+            auto const data = savg.begin() + BASELINE_BMIN;
+            auto const end  = data + BASELINE_SIZE;
 
             // Convert savg range of interest from power scale to dB scale.
 
@@ -1498,48 +1873,56 @@ namespace
             // Collect lower envelope points; use Chebyshev node interpolants
             // to reduce Runge's phenomenon oscillations.
 
+            Coefficients y;
+
             for (std::size_t i = 0; i < BASELINE_NODES.size(); ++i)
             {
-                auto const node = size * BASELINE_NODES[i];
-                auto const base = data + static_cast<int>(std::round(node));
-                auto       span = std::vector<float>(std::clamp(base - arm, data, end),
-                                                     std::clamp(base + arm, data, end));
+                std::array<float, 2 * BASELINE_ARM> span;
 
-                auto const n = span.size() * BASELINE_SAMPLE / 100;
+                auto const node  = BASELINE_SIZE * BASELINE_NODES[i];
+                auto const base  = data + static_cast<int>(std::round(node));
+                auto const first = std::clamp(base - static_cast<std::ptrdiff_t>(BASELINE_ARM), data, end);
+                auto const last  = std::clamp(base + static_cast<std::ptrdiff_t>(BASELINE_ARM), data, end);
+                auto const size  = static_cast<std::size_t>(last - first);
+                auto const n     = size * BASELINE_SAMPLE / 100;
 
-                std::nth_element(span.begin(), span.begin() + n, span.end());
+                std::copy(first, last, span.begin());
+                std::nth_element(span.begin(), span.begin() + n, span.begin() + size);
 
-                p.row(i) << node, span[n];
-            }
-
-            // Extract x and y values from points and prepare the Vandermonde
-            // matrix, initializing the first column with 1 (x^0); remaining
-            // columns are filled with the Schur product.
-
-            Eigen::VectorXd x = p.col(0);
-            Eigen::VectorXd y = p.col(1);
-
-            V.col(0).setOnes();
-            for (Eigen::Index i = 1; i < V.cols(); ++i)
-            {
-                V.col(i) = V.col(i - 1).cwiseProduct(x);
+                y[i] = span[n];
             }
 
             // Solve the least squares problem for polynomial coefficients.
 
-            c = V.colPivHouseholderQr().solve(y);
+            Coefficients const c = baselineSolver().solve(y);
 
-            // To map an index i in the range [ia, ib] to the polynomial's
-            // input domain [0, size - 1]:
+            // If the range has changed, compute the basis for it. To map an
+            // index i in the range [ia, ib] to the polynomial's input domain
+            // [0, size - 1]:
             //
             //      i  - ia
             //  x = ------- * (size - 1)
             //      ib - ia
 
-            auto const mapIndex = [ia, ib, last = size - 1](int const i)
+            if (baseline.ia != ia ||
+                baseline.ib != ib)
             {
-                return (i - ia) * last / float(ib - ia);
-            };
+                baseline.ia = ia;
+                baseline.ib = ib;
+                baseline.basis.resize(ib - ia + 1, Eigen::NoChange);
+
+                for (int i = ia; i <= ib; ++i)
+                {
+                    double const x = (i - ia) * (BASELINE_SIZE - 1) / float(ib - ia);
+
+                    baseline.basis(i - ia, 0) = 1.0;
+
+                    for (Eigen::Index j = 1; j < baseline.basis.cols(); ++j)
+                    {
+                        baseline.basis(i - ia, j) = baseline.basis(i - ia, j - 1) * x;
+                    }
+                }
+            }
 
             // Replace savg with a computed baseline in the range [ia, ib].
             // This might be interpolation, which should be quite accurate,
@@ -1547,11 +1930,13 @@ namespace
             // from the polynomial fitting domain, but hopefully still good
             // enough for our purposes here.
 
+            baseline.values.noalias() = baseline.basis * c;
+
             savg.fill(0.0f);
 
             for (int i = ia; i <= ib; ++i)
             {
-                savg[i] = evaluate(mapIndex(i)) + 0.65f;
+                savg[i] = static_cast<float>(baseline.values[i - ia]) + 0.65f;
             }
         }
 
@@ -1577,7 +1962,7 @@ namespace
             std::copy(dd.begin(), dd.end(),  fftw_real);
             std::fill(fftw_real + dd.size(), fftw_real + Mode::NDFFT1, 0.0f);
 
-            fftwf_execute(plans[Plan::BB]);
+            plans[Plan::BB].execute(ds_cx.data());
         }
 
         // This function extracts a narrow frequency band around the target frequency f0,
@@ -1586,8 +1971,11 @@ namespace
         // and normalizes the result for further processing in the JS8 decoding pipeline.
 
         void
-        js8_downsample(float const f0)
+        js8_downsample(Scratch     & scratch,
+                       float const   f0)
         {
+            ScopedTimer const scopedTimer(timer(Stage::DOWNSAMPLE));
+
             // Frequency band extraction; identifies a narrow frequency band around the
             // target frequency (f0) based on a predefined range (8.5 baud above and 1.5
             // baud below). The indices of this range in the frequency-domain representation
@@ -1606,7 +1994,14 @@ namespace
             std::size_t const NDD_SIZE = Mode::NDD + 1;
             std::size_t const RANGE_SIZE = it - ib + 1;
 
-            std::fill_n(cd0.begin(), Mode::NDFFT2, ZERO);
+            auto & cd0 = scratch.cd0;
+
+            // Note that we clear the entirety of cd0, not just the NDFFT2 size
+            // of the inverse FFT; the sync search can read beyond that, and it
+            // must see the same thing regardless of what the scratch space was
+            // last used for.
+
+            cd0.fill(ZERO);
 
             std::copy(ds_cx.begin() + ib,
                       ds_cx.begin() + ib + RANGE_SIZE,
@@ -1632,7 +2027,7 @@ namespace
             // back into the time domain, effectively yielding a downsampled, time-domain signal
             // focused on the extracted narrow frequency band.
 
-            fftwf_execute(plans[Plan::DS]);
+            scratch.plans[Plan::DS].execute(scratch.cd0.data());
 
             // The resulting time-domain samples are normalized by a factor derived from the
             // input and output FFT sizes (Mode::NDFFT1 and Mode::NDFFT2), ensuring consistency
@@ -1682,9 +2077,9 @@ namespace
 	    //
         // 5.  Normalization:
 	    //
-        //     - The sync values are normalized to the 40th percentile value using a ranked
-        //       index. This ensures a consistent scaling across different signals and noise
-        //       levels.
+        //     - The sync values are normalized to the 40th percentile value, found using a
+        //       partial sort. This ensures a consistent scaling across different signals and
+        //       noise levels.
         //
 	    // 6.  Candidate Extraction:
         //
@@ -1708,33 +2103,49 @@ namespace
         syncjs8(int nfa,
                 int nfb)
         {
-            // Compute symbol spectra
+            ScopedTimer const scopedTimer(timer(Stage::SYNC));
 
-            savg.fill(0.0f);
+            // Compute symbol spectra, for those columns that are dirty; the
+            // rest are unchanged since we last computed them, or were
+            // restored from the previous decode.
 
-            for (int j = 0; j < Mode::NHSYM; ++j)
+            for (int j = 0; j < NCOLS; ++j)
             {
+                if (!dirty[j]) continue;
+
                 int const ia = j  * Mode::NSTEP;
                 int const ib = ia + Mode::NFFT1;
 
-                if (ib > Mode::NMAX) break;
-
                 std::transform(dd.begin() + ia,
                                dd.begin() + ib,
                                nuttal.begin(),
                                reinterpret_cast<float *>(sd.data()),
                                std::multiplies<float>{});
 
-                fftwf_execute(plans[Plan::SD]);
+                plans[Plan::SD].execute(sd.data());
 
                 // Compute power spectrum
 
-                for (int i = 0; i < Mode::NSPS; ++i)
-                {
-                    auto const power = std::norm(sd[i]);
-                    s[i][j]  = power;
-                    savg[i] += power;
-                }
+                std::transform(sd.begin(),
+                               sd.begin() + Mode::NSPS,
+                               s[j].begin(),
+                               [](auto const value) { return std::norm(value); });
+            }
+
+            dirty.reset();
+
+            // Accumulate the average spectrum in column order, so that it's
+            // the same regardless of where the columns came from.
+
+            savg.fill(0.0f);
+
+            for (int j = 0; j < NCOLS; ++j)
+            {
+                std::transform(savg.begin(),
+                               savg.end(),
+                               s[j].begin(),
+                               savg.begin(),
+                               std::plus<float>{});
             }
 
             // Filter edge sanity measures
@@ -1761,18 +2172,28 @@ namespace
 
             baselinejs8(ia, ib);
 
-            // Compute and populate the sync index.
+            // Compute and populate the sync index. The spectra are stored in
+            // time-major order, so the search runs across a tile of adjacent
+            // frequency bins at a time; the innermost loops then read rows of
+            // contiguous bins, which the compiler will vectorize. Each bin is
+            // still accumulated in the Fortran order, independently of the
+            // others, so the results are unchanged.
 
             sync.clear();
 
-            for (int i = ia; i <= ib; ++i)
+            for (int i0 = ia; i0 <= ib; i0 += NTILE)
             {
-                float max_value = -std::numeric_limits<float>::infinity();
-                int   max_index = -Mode::JZ;
+                int const width = std::min(NTILE, ib - i0 + 1);
+
+                std::array<float, NTILE> max_value;
+                std::array<int,   NTILE> max_index;
+
+                max_value.fill(-std::numeric_limits<float>::infinity());
+                max_index.fill(-Mode::JZ);
 
                 for (int j = -Mode::JZ; j <= Mode::JZ; ++j)
                 {
-                    std::array<std::array<float, 3>, 2> t{};
+                    std::array<std::array<std::array<float, NTILE>, 3>, 2> t{};
 
                     for (int p = 0; p < 3; ++p)
                     {
@@ -1782,15 +2203,27 @@ namespace
 
                             if (offset >= 0 && offset < Mode::NHSYM)
                             {
+                                auto const row = s[offset].data() + i0;
+
                                 // Accumulate Costas pattern contributions.
 
-                                t[0][p] += s[i + NFOS * Costas[p][n]][offset];
+                                auto const costas = row + NFOS * Costas[p][n];
+
+                                for (int k = 0; k < width; ++k)
+                                {
+                                    t[0][p][k] += costas[k];
+                                }
 
                                 // Accumulate sum over all frequencies for this block.
 
                                 for (int freq = 0; freq < 7; ++freq)
                                 {
-                                    t[1][p] += s[i + NFOS * freq][offset];
+                                    auto const bins = row + NFOS * freq;
+
+                                    for (int k = 0; k < width; ++k)
+                                    {
+                                        t[1][p][k] += bins[k];
+                                    }
                                 }
                             }
                         }
@@ -1802,97 +2235,51 @@ namespace
                     // addition is a touchy thing, so we'll need to ensure that any
                     // changes don't negatively affect result precision.
 
-                    auto const compute_sync = [&t](int start, int end)
+                    auto const compute_sync = [&t](int const k,
+                                                   int const start,
+                                                   int const end)
                     {
                         float tx = 0.0f;
                         float t0 = 0.0f;
 
                         for (int i = start; i <= end; ++i)
                         {
-                            tx += t[0][i];
-                            t0 += t[1][i];
+                            tx += t[0][i][k];
+                            t0 += t[1][i][k];
                         }
 
                         return tx / ((t0 - tx) / 6.0f);
                     };
 
-                    if (auto const sync_value = std::max({
-                            compute_sync(0, 2),
-                            compute_sync(0, 1),
-                            compute_sync(1, 2)
-                        }); sync_value > max_value)
+                    for (int k = 0; k < width; ++k)
                     {
-                        max_value = sync_value;
-                        max_index = j;
+                        if (auto const sync_value = std::max({
+                                compute_sync(k, 0, 2),
+                                compute_sync(k, 0, 1),
+                                compute_sync(k, 1, 2)
+                            }); sync_value > max_value[k])
+                        {
+                            max_value[k] = sync_value;
+                            max_index[k] = j;
+                        }
                     }
                 }
 
-                sync.emplace(Mode::DF    * i,
-                             Mode::TSTEP * (max_index + 0.5f),
-                                            max_value);
+                for (int k = 0; k < width; ++k)
+                {
+                    sync.emplace(Mode::DF    * (i0 + k),
+                                 Mode::TSTEP * (max_index[k] + 0.5f),
+                                                max_value[k]);
+                }
             }
 
             // If we found nothing, we're done here.
 
             if (sync.empty()) return {};
 
-            // Access the sync indices.
-
-            auto & freqIndex = sync.get<Tag::Freq>();
-            auto & rankIndex = sync.get<Tag::Rank>();
-            auto & syncIndex = sync.get<Tag::Sync>();
-
-            // Normalize to the 40th percentile using the frequency index,
-            // which is stable under sync value mutation. One thing to note
-            // here is that the Fortran version didn't seem to reliably
-            // calculate the 40th percentile rank; sometimes high, other
-            // times low, infrequently actually the 40th percentile value.
-            // This method should be perfectly accurate in all cases.
-
-            auto const normalize =
-            [
-               sync = rankIndex.nth(rankIndex.size() * 4 / 10)->sync
-            ]
-            (Sync & entry)
-            {
-                entry.sync /= sync;
-            };
-
-            for (auto it  = freqIndex.begin();
-                      it != freqIndex.end();
-                    ++it)
-            {
-                freqIndex.modify(it, normalize);
-            }
-
-            // Extract candidates.
-
-            std::vector<Sync> candidates;
-
-            for (auto it  = syncIndex.begin();
-                      it != syncIndex.end() && candidates.size() < NMAXCAND;
-                      it  = syncIndex.begin())
-            {
-                // Stop iteration if below threshold or invalid; as the
-                // index is sorted by sync, any subsequent entries will
-                // also be below the threshold or invalid.
-
-                if (it->sync < ASYNCMIN || std::isnan(it->sync)) break;
-
-                // Good value, relatively strong; save the candidate.
+            ScopedTimer const candidateTimer(timer(Stage::CANDIDATES));
 
-                candidates.push_back(*it);
-
-                // Remove the candidate and any near-duplicates based
-                // on frequency. This invalidates `it`, so we reset it
-                // to the index begin in the loop increment condition.
-
-                freqIndex.erase(
-                    freqIndex.lower_bound(it->freq - Mode::AZ),
-                    freqIndex.upper_bound(it->freq + Mode::AZ));
-            }
-
-            return candidates;
+            return sync.candidates(Mode::AZ);
         }
 
         // Returns the total synchronization power, which is a measure of how well
@@ -1901,8 +2288,9 @@ namespace
         // decoding.
 
         float
-        syncjs8d(int   const i0,
-                 float const delf)
+        syncjs8d(Scratch const & scratch,
+                 int     const   i0,
+                 float   const   delf)
         {
             constexpr float BASE_DPHI = TAU * (1.0f / (12000.0f / Mode::NDOWN));
 
@@ -1953,7 +2341,7 @@ namespace
                             std::transform_reduce(
                                 freqAdjust.begin(),     // Range start
                                 freqAdjust.end(),       // Range end
-                                cd0.begin() + offset,   // Data start
+                                scratch.cd0.begin() + offset, // Data start
                                 std::complex<float>{},  // Initial reduction value
                                 std::plus<>{},          // Reduction by accumulation
                                 [&](auto const & fa,    // Conjugate and multiply
@@ -1969,11 +2357,11 @@ namespace
             return sync;
         }
 
-        // Generate a reference signal, based on the provided tone sequence and
-        // base frequency. The output is a vector of complex values representing
-        // the signal in the time domain.
+        // Generate a reference signal into `cref`, based on the provided tone
+        // sequence and base frequency, representing the signal in the time
+        // domain.
 
-        std::vector<std::complex<float>>
+        void
         genjs8refsig(std::array<int, NN> const & itone,
                      float               const   f0)
         {
@@ -1985,9 +2373,7 @@ namespace
 
             float const BFPI = TAU * f0 * (1.0f / 12000.0f);
             auto        phi  = 0.0f;
-
-            std::vector<std::complex<float>> cref;
-            cref.reserve(NN * Mode::NSPS);
+            auto        it   = cref.begin();
 
             for (int i = 0; i < NN; ++i)
             {
@@ -2001,12 +2387,10 @@ namespace
 
                 for (std::size_t is = 0; is < Mode::NSPS; ++is)
                 {
-                    cref.push_back(std::polar(1.0f, phi));
-                    phi = std::fmod(phi + dphi, TAU);
+                    *it++ = std::polar(1.0f, phi);
+                    phi   = std::fmod(phi + dphi, TAU);
                 }
             }
-
-            return cref;
         }
 
         // Subtract a JS8 signal
@@ -2017,49 +2401,183 @@ namespace
         // Subtract         : dd(t)    = dd(t) - 2*REAL{cref*cfilt}
         //
         // Important to note that dt can be negative here.
-        
+        //
+        // The Fortran version filtered the amplitude over the whole of `dd`,
+        // zero outside of the signal, by circular convolution; since the filter
+        // is causal and `dd` is longer than any signal by more than NFILT, that
+        // amounts to a linear convolution of the amplitude with the filter. We
+        // compute the same thing by overlap-save, over the duration of the
+        // signal only, in blocks of NSUB points, each of which yields the
+        // filtered amplitude for the NSUB - NFILT points following its leading
+        // NFILT points, i.e., the points that the filter can reach back to.
+        // We must be careful not to subtract from anything that's yet to be
+        // filtered; the leading NFILT points of each block are the trailing
+        // NFILT points of the previous one, so we carry those over rather than
+        // re-reading them from `dd`.
+
         void
-        subtractjs8(std::vector<std::complex<float>> const & cref,
-                    float                            const   dt)
+        subtractjs8(std::array<int, NN> const & itone,
+                    float               const   f0,
+                    float               const   dt)
         {
+            constexpr int BLOCK = NSUB - NFILT;
+
+            genjs8refsig(itone, f0);
+
             auto        const nstart     = static_cast<int>(dt * 12000.0f);
             std::size_t const cref_start = (nstart < 0) ? static_cast<std::size_t>(-nstart) : 0;
             std::size_t const dd_start   = (nstart > 0) ? static_cast<std::size_t>( nstart) : 0;
-            auto        const size       = std::min(cref.size() - cref_start, dd.size() - dd_start);
+            auto        const size       = static_cast<int>(std::min(cref.size() - cref_start, dd.size() - dd_start));
+
+            auto const & filter = subtractionFilter();
+
+            // Complex amplitude at a point relative to the start of the signal,
+            // i.e., the measured signal multiplied by the conjugate of the
+            // reference signal; zero outside of the signal.
 
-            // Populate complex filter with the conjugate of the reference signal.
+            auto const amplitude = [&](int const i)
+            {
+                return (i < 0 || i >= size) ? ZERO
+                                            : dd[dd_start + i] * std::conj(cref[cref_start + i]);
+            };
+
+            // The first block is preceded by nothing but zeros.
+
+            std::array<std::complex<float>, NFILT> carry;
 
-            for (std::size_t i = 0; i < size; ++i)
+            for (int i = 0; i < NFILT; ++i) carry[i] = amplitude(i - NFILT);
+
+            for (int start = 0; start < size; start += BLOCK)
             {
-                cfilt[i] = dd[dd_start + i] * std::conj(cref[cref_start + i]);
+                // Assemble the block, carrying over the trailing points of the
+                // previous one, and save the trailing points of this one.
+
+                std::copy(carry.begin(), carry.end(), csub.begin());
+
+                for (int i = NFILT; i < NSUB; ++i) csub[i] = amplitude(start - NFILT + i);
+
+                std::copy(csub.end() - NFILT, csub.end(), carry.begin());
+
+                // FFT to the frequency domain, apply the filter, and inverse
+                // FFT to return to the time domain.
+
+                plans[Plan::CF].execute(csub.data());
+
+                std::transform(csub.begin(),
+                               csub.end(),
+                               filter.begin(),
+                               csub.begin(),
+                               std::multiplies<>());
+
+                plans[Plan::CB].execute(csub.data());
+
+                // Subtract the reconstructed signal; the first NFILT points of
+                // the block are corrupted by circular wrap, and serve only as
+                // history for the points following them.
+
+                for (int i = 0, end = std::min(BLOCK, size - start); i < end; ++i)
+                {
+                    dd[dd_start + start + i] -= 2.0f * std::real(csub[NFILT + i] * cref[cref_start + start + i]);
+                }
             }
 
-            // Zero-fill the remainder, if any.
+            // Mark the symbol spectra columns overlapping the samples we've
+            // modified, i.e., those in the range [dd_start, dd_start + size),
+            // as requiring recomputation.
 
-            std::fill(cfilt.begin() + size, cfilt.end(), ZERO);
+            if (size > 0)
+            {
+                int const first = std::max(0, static_cast<int>(dd_start) - Mode::NFFT1 + Mode::NSTEP) / Mode::NSTEP;
+                int const last  = std::min(NCOLS - 1, (static_cast<int>(dd_start) + size - 1) / Mode::NSTEP);
+
+                for (int j = first; j <= last; ++j) dirty.set(j);
+            }
+        }
 
-            // FFT to the frequency domain.
+        // Subtract all of the signals decoded during a pass. This is done one
+        // signal at a time, in candidate order, each seeing the results of
+        // those before it; signals close enough in frequency to pass through
+        // each other's filter would otherwise be subtracted twice.
+
+        void
+        subtractjs8(std::vector<Result> const & results)
+        {
+            ScopedTimer const scopedTimer(timer(Stage::SUBTRACT));
 
-            fftwf_execute(plans[Plan::CF]);
+            for (auto const & result : results)
+            {
+                if (result.decode) subtractjs8(result.itone,
+                                               result.f1,
+                                               result.xdt);
+            }
+        }
 
-            // Apply the filter in the frequency domain.
+        // Decode each of the candidates provided, returning results in the
+        // same order as the candidates. If we've been provided with a thread
+        // pool, then candidates are distributed to as many threads as the
+        // pool has, with the calling thread participating as well; each of
+        // the threads claims the next undecoded candidate as it's ready for
+        // one, using a scratch space of its own. Each candidate's result is
+        // a function only of the candidate and the state of the pass, so the
+        // results are the same as those of a serial decode.
+
+        std::vector<Result>
+        decodeCandidates(std::vector<Sync> const & candidates,
+                         bool              const   syncStats,
+                         BPAlgorithm       const   algorithm,
+                         QThreadPool             * pool)
+        {
+            std::vector<Result>      results(candidates.size());
+            std::atomic<std::size_t> next = 0;
 
-            std::transform(cfilt.begin(),
-                           cfilt.end(),
-                           filter.begin(),
-                           cfilt.begin(),
-                           std::multiplies<>());
+            auto const decode = [&](Scratch & space)
+            {
+                for (auto i  = next++;
+                          i  < candidates.size();
+                          i  = next++)
+                {
+                    auto & result = results[i];
+
+                    result.f1          = candidates[i].freq;
+                    result.xdt         = candidates[i].step;
+                    result.xsnr        = 0.0f;
+                    result.nharderrors = -1;
+                    result.decode      = js8dec(space,
+                                                syncStats,
+                                                algorithm,
+                                                result.f1,
+                                                result.xdt,
+                                                result.nharderrors,
+                                                result.xsnr,
+                                                result.itone,
+                                                [&result](JS8::Event::Variant const & event)
+                                                {
+                                                    result.events.push_back(event);
+                                                });
+                }
+            };
 
-            // Inverse FFT to return to the time domain.
+            auto const threads = std::clamp<std::size_t>(pool ? pool->maxThreadCount() + 1 : 1,
+                                                         1,
+                                                         candidates.size());
 
-            fftwf_execute(plans[Plan::CB]);
+            while (scratchSpaces.size() < threads) scratchSpaces.push_back(std::make_unique<Scratch>());
 
-            // Subtract the reconstructed signal.
+            std::latch done(threads - 1);
 
-            for (std::size_t i = 0; i < size; ++i)
+            for (std::size_t i = 1; i < threads; ++i)
             {
-                dd[dd_start + i] -= 2.0f * std::real(cfilt[i] * cref[cref_start + i]);
+                pool->start([&decode, &done, &space = *scratchSpaces[i]]()
+                {
+                    decode(space);
+                    done.count_down();
+                });
             }
+
+            decode(*scratchSpaces.front());
+            done.wait();
+
+            return results;
         }
 
     public:
@@ -2130,137 +2648,183 @@ namespace
                 }
             }
 
-            // Compute a Hann-like window directly into the real part of the
-            // first NFILT + 1 elements in the filter, accumulating the sum
-            // as we go.
+            // The rest of our FFT plans are always the same size and operate on
+            // data of the same alignment, so we can reuse them as long as we're
+            // alive. Obtain the scratch space for the first candidate thread as
+            // well, such that the first decode doesn't have to wait on it.
 
-            sum = 0.0f;
+            plans[Plan::BB] = FFTW::plan({FFTW::Kind::R2C,      Mode::NDFFT1});
+            plans[Plan::CF] = FFTW::plan({FFTW::Kind::FORWARD,  NSUB});
+            plans[Plan::CB] = FFTW::plan({FFTW::Kind::BACKWARD, NSUB});
+            plans[Plan::SD] = FFTW::plan({FFTW::Kind::R2C,      Mode::NFFT1});
 
-            for (int j = -NFILT / 2; j <= NFILT / 2; ++j)
-            {
-                int   const index = j + NFILT / 2;
-                float const value = std::pow(std::cos(pi * j / NFILT), 2);
+            scratchSpaces.push_back(std::make_unique<Scratch>());
+        }
 
-                filter[index].real(value);
-                sum             += value;
-            }
+        // Copy any columns of the symbol spectra retained from the previous
+        // decode that cover the same samples as the leading columns of this
+        // one, marking all other columns dirty. Columns that extend past the
+        // end of either window include zero padding in place of samples, so
+        // they can't be used.
 
-            // Now that we've got the sum, create actual complex numbers using
-            // the normalized real values that we just populated and zero the
-            // rest of the filter.
+        void
+        restoreSpectra(std::uint32_t const epoch,
+                       int           const pos,
+                       int           const sz)
+        {
+            dirty.set();
 
-            std::fill(std::transform(filter.begin(),
-                                     filter.begin() + NFILT + 1,
-                                     filter.begin(),
-                                     [sum](auto const value)
-                                     {
-                                         return std::complex<float>(value.real() / sum, 0.0f);
-                                     }),
-                      filter.end(),
-                      ZERO);
+            if (spectra.epoch != epoch) return;
 
-            // Shift to position the window.
+            auto const offset = (pos - spectra.pos + JS8_RX_SAMPLE_SIZE) % JS8_RX_SAMPLE_SIZE;
 
-            std::rotate(filter.begin(),
-                        filter.begin() + NFILT / 2,
-                        filter.begin() + NFILT + 1);
+            if (offset % Mode::NSTEP || offset >= spectra.sz) return;
 
-            // Transform the filter into the frequency domain.
+            auto const limit = std::min(spectra.sz - offset, sz);
 
-            fftwf_plan fftw_plan;
-            {
-                std::lock_guard<std::mutex> lock(fftw_mutex);
-
-                fftw_plan = fftwf_plan_dft_1d(Mode::NMAX,
-                                              reinterpret_cast<fftwf_complex *>(filter.data()),
-                                              reinterpret_cast<fftwf_complex *>(filter.data()),
-                                              FFTW_FORWARD,
-                                              FFTW_ESTIMATE_PATIENT);
-                                                
-                if (!fftw_plan)
-                {
-                    throw std::runtime_error("Failed to create FFT plan");
-                }                     
-            }
+            if (limit < Mode::NFFT1) return;
 
-            fftwf_execute(fftw_plan);
+            auto const shift = offset / Mode::NSTEP;
+            auto const valid = std::min((limit - Mode::NFFT1) / Mode::NSTEP + 1, NCOLS);
 
-            {
-                std::lock_guard<std::mutex> lock(fftw_mutex);
-                fftwf_destroy_plan(fftw_plan);
-            }
+            std::copy_n(spectra.s.begin() + shift,
+                        valid,
+                        s.begin());
 
-            // Normalize the frequency domain representation.
+            for (int j = 0; j < valid; ++j) dirty.reset(j);
+        }
 
-            std::transform(filter.begin(),
-                           filter.end(),
-                           filter.begin(),
-                           [factor = 1.0f / Mode::NMAX](auto value)
-                           {
-                               return value * factor;
-                           });
+        // Retain the symbol spectra computed for the first pass of a decode,
+        // prior to any subtraction, for use by the next decode.
 
-            // The rest of our FFT plans are always the same size and operate on the
-            // same data, so we can reuse them as long as we're alive.
-
-            std::lock_guard<std::mutex> lock(fftw_mutex);
-
-            plans[Plan::DS] = fftwf_plan_dft_1d(Mode::NDFFT2,
-                                                reinterpret_cast<fftwf_complex *>(cd0.data()),
-                                                reinterpret_cast<fftwf_complex *>(cd0.data()),
-                                                FFTW_BACKWARD,
-                                                FFTW_ESTIMATE_PATIENT);
-
-            plans[Plan::BB] = fftwf_plan_dft_r2c_1d(Mode::NDFFT1,
-                                                    reinterpret_cast<float         *>(ds_cx.data()),
-                                                    reinterpret_cast<fftwf_complex *>(ds_cx.data()),
-                                                    FFTW_ESTIMATE_PATIENT);
-
-            plans[Plan::CF] = fftwf_plan_dft_1d(Mode::NMAX,
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                FFTW_FORWARD,
-                                                FFTW_ESTIMATE_PATIENT);
-
-            plans[Plan::CB] = fftwf_plan_dft_1d(Mode::NMAX,
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                reinterpret_cast<fftwf_complex *>(cfilt.data()),
-                                                FFTW_BACKWARD,
-                                                FFTW_ESTIMATE_PATIENT);
-
-            plans[Plan::SD] = fftwf_plan_dft_r2c_1d(Mode::NFFT1,
-                                                    reinterpret_cast<float         *>(sd.data()),
-                                                    reinterpret_cast<fftwf_complex *>(sd.data()),
-                                                    FFTW_ESTIMATE_PATIENT);
-                
-            plans[Plan::CS] = fftwf_plan_dft_1d(Mode::NDOWNSPS,
-                                                reinterpret_cast<fftwf_complex *>(csymb.data()),
-                                                reinterpret_cast<fftwf_complex *>(csymb.data()),
-                                                FFTW_FORWARD,
-                                                FFTW_ESTIMATE_PATIENT);
+        void
+        saveSpectra(std::uint32_t const epoch,
+                    int           const pos,
+                    int           const sz)
+        {
+            spectra.s     = s;
+            spectra.epoch = epoch;
+            spectra.pos   = pos;
+            spectra.sz    = sz;
+        }
 
-            for (auto plan : plans)
+        // Number of frames, from the start of the window, required for the
+        // candidate's frame to be present in its entirety, allowing for the
+        // refinement of its start performed by js8dec(), and the number of
+        // frames required for the first two of its Costas arrays, which is
+        // the point at which we consider a candidate worth carrying forward.
+        // For a signal starting with the window, the latter is the submode's
+        // framesForCostas(), at which the main window starts early decoding.
+
+        static int
+        framesForCandidate(Sync const & candidate)
+        {
+            return static_cast<int>((candidate.step + Mode::ASTART) * JS8_RX_SAMPLE_RATE) + NN * Mode::NSPS + Mode::NSPS / 4;
+        }
+
+        static int
+        framesForCostas(Sync const & candidate)
+        {
+            return static_cast<int>((candidate.step + Mode::ASTART) * JS8_RX_SAMPLE_RATE) + (36 + 7) * Mode::NSPS;
+        }
+
+        // Early decoding; partition the candidates found in a partially
+        // filled window into those whose frames are complete, which are
+        // returned for decoding, and those which aren't. On the first pass,
+        // incomplete candidates having at least two Costas arrays present
+        // are retained; those retained by the previous decode of the same
+        // window are merged in, with a newly found candidate superseding a
+        // retained one if it's nearby and has the better sync, i.e., sync
+        // and DT estimates improve as symbols arrive, but a candidate isn't
+        // lost if it's briefly obscured. Returns the candidates to decode,
+        // and the frames required for the earliest retained candidate to
+        // complete, if there is one.
+
+        std::pair<std::vector<Sync>, std::optional<int>>
+        partitionEarly(std::vector<Sync>         candidates,
+                       std::uint32_t     const   epoch,
+                       int               const   pos,
+                       int               const   sz,
+                       bool              const   retain)
+        {
+            if (retain)
             {
-                if (!plan) throw std::runtime_error("Failed to create FFT plan");
+                if (early.epoch == epoch && early.pos == pos)
+                {
+                    for (auto const & retained : early.candidates)
+                    {
+                        auto const nearby = std::find_if(candidates.begin(),
+                                                         candidates.end(),
+                                                         [&retained](auto const & candidate)
+                                                         {
+                                                             return std::abs(candidate.freq - retained.freq) <= Mode::AZ;
+                                                         });
+
+                        if      (nearby == candidates.end()) candidates.push_back(retained);
+                        else if (nearby->sync < retained.sync) *nearby = retained;
+                    }
+                }
+
+                early.epoch = epoch;
+                early.pos   = pos;
+                early.candidates.clear();
             }
+
+            std::vector<Sync>  complete;
+            std::optional<int> pending;
+
+            for (auto const & candidate : candidates)
+            {
+                if (auto const frames = framesForCandidate(candidate); frames <= sz || sz == Mode::NMAX)
+                {
+                    complete.push_back(candidate);
+                }
+                else if (retain && framesForCostas(candidate) <= sz && frames <= Mode::NMAX)
+                {
+                    early.candidates.push_back(candidate);
+                    pending = std::min(pending.value_or(frames), frames);
+                }
+            }
+
+            return {std::move(complete), pending};
         }
 
         // Decode entry point.
 
         std::size_t
-        operator()(struct dec_data const & data,
-                   int             const   kpos,
-                   int             const   ksz,
-                   JS8::Event::Emitter     emitEvent)
+        operator()(Snapshot      const & snapshot,
+                   int           const   kpos,
+                   int           const   ksz,
+                   QThreadPool         * pool,
+                   JS8::Event::Emitter   emitEvent,
+                   JS8::Timings        * timings = nullptr)
         {
-            // Copy the relevant frames for decoding
+            auto const & params = snapshot.params;
+            auto const   lag    = std::chrono::steady_clock::now() - snapshot.requested;
+
+            // If the caller wants timings or stats, start the counters from
+            // zero; we'll add them to the caller's timings, or emit them, once
+            // we're done.
+
+            timing.enabled = timings != nullptr || params.stats;
+
+            for (auto & counter : timing.passes) counter.store(0, std::memory_order_relaxed);
+            for (auto & counter : timing.stages) counter.store(0, std::memory_order_relaxed);
+
+            timing.candidates.fill(0);
+            timing.decoded   .fill(0);
+            timing.bpDecodes   .store(0, std::memory_order_relaxed);
+            timing.bpCodewords .store(0, std::memory_order_relaxed);
+            timing.bpIterations.store(0, std::memory_order_relaxed);
+
+            // Convert the relevant frames for decoding
 
             auto const pos = std::max(0, kpos);
             auto const sz  = std::max(0, ksz);
 
             assert(sz <= Mode::NMAX);
 
-            if (data.params.syncStats) emitEvent(JS8::Event::SyncStart{pos, sz});
+            if (params.syncStats) emitEvent(JS8::Event::SyncStart{pos, sz});
 
             auto const ddCopy = [](auto const begin,
                                    auto const end,
@@ -2272,6 +2836,18 @@ namespace
                 });
             };
 
+            // If the sample buffer has been modified since our snapshot, other
+            // than by appending, then the window no longer contains what we
+            // were asked to decode; the same applies if it's modified while
+            // we're reading from it.
+
+            auto const stable = [&snapshot]()
+            {
+                return snapshot.d2epoch->load(std::memory_order_acquire) == snapshot.epoch;
+            };
+
+            if (!stable()) return 0;
+
             dd.fill(0.0f);
 
             if ((JS8_RX_SAMPLE_SIZE - pos) < sz)
@@ -2281,33 +2857,73 @@ namespace
                 int const firstsize  = JS8_RX_SAMPLE_SIZE - pos;
                 int const secondsize = sz - firstsize;
 
-                ddCopy(std::begin(data.d2) + pos, std::begin(data.d2) + pos + firstsize,  dd.begin());
-                ddCopy(std::begin(data.d2),       std::begin(data.d2) +       secondsize, dd.begin() + firstsize);
+                ddCopy(snapshot.d2 + pos, snapshot.d2 + pos + firstsize,  dd.begin());
+                ddCopy(snapshot.d2,       snapshot.d2 +       secondsize, dd.begin() + firstsize);
             }
             else
             {
-                // Non-wrapping case; copy directly.
+                // Non-wrapping case; convert directly.
+
+                ddCopy(snapshot.d2 + pos, snapshot.d2 + pos + sz, dd.begin());
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
 
-                ddCopy(std::begin(data.d2) + pos, std::begin(data.d2) + pos + sz, dd.begin());
+            if (!stable())
+            {
+                if (JS8_DEBUG_DECODE) qDebug() << "sample buffer modified during decode of submode" << Mode::NSUBMODE;
+                return 0;
             }
 
             Decode::Map decodes;
 
             for (int ipass = 1; ipass <= 3; ++ipass)
             {
+                ScopedTimer const passTimer(timing.enabled ? &timing.passes[ipass - 1] : nullptr);
+
                 // Determine if there's anything worth considering in the signal.
                 // If not, then we can just bail completely; more passes will not
                 // yield more results. If we do have some candidates, sort them
                 // by frequency, but put any that are close to nfqso up front.
 
-                auto candidates = syncjs8(data.params.nfa,
-                                          data.params.nfb);
+                if (ipass == 1) restoreSpectra(snapshot.epoch, pos, sz);
+
+                auto candidates = syncjs8(params.nfa,
+                                          params.nfb);
+
+                if (ipass == 1) saveSpectra(snapshot.epoch, pos, sz);
+
+                // When benchmarking the sync search, that's all we're to do.
+
+                if (params.syncOnly)
+                {
+                    timing.candidates[0] = static_cast<int>(candidates.size());
+                    break;
+                }
+
+                // When decoding early, a candidate is decoded only once all
+                // of its frame has arrived; let the caller know when the
+                // next of those we're waiting on will have done so.
+
+                if (params.early)
+                {
+                    auto [complete, pending] = partitionEarly(std::move(candidates),
+                                                              snapshot.epoch,
+                                                              pos,
+                                                              sz,
+                                                              ipass == 1);
+                    candidates = std::move(complete);
+
+                    if (pending) emitEvent(JS8::Event::DecodePending{Mode::NSUBMODE, pos, *pending});
+                }
 
                 if (candidates.empty()) break;
 
+                timing.candidates[ipass - 1] = static_cast<int>(candidates.size());
+
                 std::sort(candidates.begin(),
                           candidates.end(),
-                          [nfqso = data.params.nfqso](auto const & a,
+                          [nfqso = params.nfqso](auto const & a,
                                                       auto const & b)
                           {
                             auto const a_dist = std::abs(a.freq - nfqso);
@@ -2325,64 +2941,123 @@ namespace
 
                 computeBasebandFFT();
 
-                bool const subtract = ipass < 3;
                 bool       improved = false;
+                auto const results  = decodeCandidates(candidates,
+                                                       params.syncStats,
+                                                       params.minsum ? BPAlgorithm::MinSum
+                                                                     : BPAlgorithm::SumProduct,
+                                                       pool);
+
+                // Merge the results in candidate order.
 
-                for (auto [f1, xdt, sync] : candidates)
+                for (auto const & result : results)
                 {
-                    float xsnr        =  0.0f;
-                    int   nharderrors = -1;
-
-                    if (auto decode = js8dec(data.params.syncStats,
-                                             subtract,
-                                             f1,
-                                             xdt,
-                                             nharderrors,
-                                             xsnr,
-                                             emitEvent))
-                    {
-                        // We don't need to be emitting duplicate events for something
-                        // that's effectively the same SNR as a previous event.
+                    for (auto const & event : result.events) emitEvent(event);
 
-                        auto const snr = static_cast<int>(std::round(xsnr));
+                    if (!result.decode) continue;
 
-                        // If this decode is new, or it's a duplicate with a better SNR
-                        // than what we had before, then our situation has improved and 
-                        // we must announce that we've had some success.
+                    // We don't need to be emitting duplicate events for something
+                    // that's effectively the same SNR as a previous event.
 
-                        if (auto [it, inserted] = decodes.try_emplace(std::move(*decode), snr);
-                                      inserted || it->second < snr)
-                        {
-                            improved = true;
+                    auto const snr = static_cast<int>(std::round(result.xsnr));
 
-                            // Update the SNR if this is an improved decode.
+                    // If this decode is new, or it's a duplicate with a better SNR
+                    // than what we had before, then our situation has improved and 
+                    // we must announce that we've had some success.
 
-                            if (!inserted) it->second = snr;
+                    if (auto [it, inserted] = decodes.try_emplace(*result.decode, snr);
+                                  inserted || it->second < snr)
+                    {
+                        improved = true;
 
-                            // Emit decoded events on new or improved decodes.
+                        ++timing.decoded[ipass - 1];
 
-                            emitEvent(JS8::Event::Decoded{data.params.nutc,
-                                                          snr,
-                                                          xdt - Mode::ASTART,
-                                                          f1,
-                                                          it->first.data,
-                                                          it->first.type,
-                                                          1.0f - nharderrors / 60.0f,
-                                                          Mode::NSUBMODE});
-                        }
+                        // Update the SNR if this is an improved decode.
+
+                        if (!inserted) it->second = snr;
+
+                        // Emit decoded events on new or improved decodes.
+
+                        emitEvent(JS8::Event::Decoded{params.nutc,
+                                                      snr,
+                                                      result.xdt - Mode::ASTART,
+                                                      result.f1,
+                                                      it->first.data,
+                                                      it->first.type,
+                                                      1.0f - result.nharderrors / 60.0f,
+                                                      Mode::NSUBMODE});
                     }
                 }
 
+                // Subtract decoded signals on all but the last pass, again in
+                // candidate order. Candidates within a pass are all decoded from
+                // the baseband computed at the start of the pass, so deferring
+                // subtraction to this point doesn't change what they decoded.
+
+                if (ipass < 3) subtractjs8(results);
+
                 // If nothing from this pass improved our situation, there's no
                 // point in trying any remaining passes.
 
                 if (!improved) break;
             }
 
+            if (timing.enabled)
+            {
+                auto const elapsed = [](auto const & counter)
+                {
+                    return std::chrono::nanoseconds(counter.load(std::memory_order_relaxed));
+                };
+
+                JS8::Timings measured;
+
+                for (std::size_t i = 0; i < timing.passes.size(); ++i) measured.passes[i] = elapsed(timing.passes[i]);
+
+                measured.sync       = elapsed(timing.stages[static_cast<std::size_t>(Stage::SYNC)]);
+                measured.candidates = elapsed(timing.stages[static_cast<std::size_t>(Stage::CANDIDATES)]);
+                measured.downsample = elapsed(timing.stages[static_cast<std::size_t>(Stage::DOWNSAMPLE)]);
+                measured.bpdecode   = elapsed(timing.stages[static_cast<std::size_t>(Stage::BPDECODE)]);
+                measured.subtract   = elapsed(timing.stages[static_cast<std::size_t>(Stage::SUBTRACT)]);
+
+                if (timings) *timings += measured;
+
+                if (params.stats) emitEvent(JS8::Event::Stats{Mode::NSUBMODE,
+                                                              std::chrono::duration_cast<std::chrono::nanoseconds>(lag),
+                                                              measured,
+                                                              timing.candidates,
+                                                              timing.decoded,
+                                                              timing.bpDecodes   .load(std::memory_order_relaxed),
+                                                              timing.bpCodewords .load(std::memory_order_relaxed),
+                                                              timing.bpIterations.load(std::memory_order_relaxed)});
+            }
+
             // Let the caller know how many unique decodes we discovered, if any.
 
             return decodes.size();
         }
+
+#ifdef JS8_TESTING
+        // Subtract a signal having the tones provided from the samples
+        // provided, as we would once we'd decoded it, leaving the samples
+        // that remain and the reference signal used in the result.
+
+        void
+        subtract(std::int16_t        const * const   samples,
+                 int                         const   size,
+                 std::array<int, NN> const &         itone,
+                 float                       const   f0,
+                 float                       const   dt,
+                 JS8::Testing::Subtraction         & result)
+        {
+            std::fill(dd.begin(), dd.end(), 0.0f);
+            std::copy(samples, samples + std::clamp(size, 0, Mode::NMAX), dd.begin());
+
+            subtractjs8(itone, f0, dt);
+
+            result.residual .assign(dd.begin(),   dd.end());
+            result.reference.assign(cref.begin(), cref.end());
+        }
+#endif
     };
 
     // Explicit template class instantiations; avoids compiler complaints
@@ -2411,16 +3086,21 @@ namespace JS8
 
         class Impl
         {
-            // To avoid data races, decode data is referenced here but is
-            // actually located in the Worker that instantiates us, as it
-            // must be possible to copy data for us before we're ready to
-            // process it.
+            // To avoid data races, the decode snapshot is referenced here but
+            // is actually located in the Worker that instantiates us, as it
+            // must be possible to take a snapshot for us before we're ready
+            // to process it.
 
-            struct dec_data & m_data;
+            Snapshot & m_snapshot;
 
             // Mode-specific decode strategy; we'll instantiate one of
             // these for each of the 5 modes; this class is an aggregate
             // of the 5 modes.
+            //
+            // Each entry is dispatched to the decoder thread pool as an
+            // independent task, so each one must carry its own results;
+            // events emitted during the decode are buffered here until
+            // the entry can be released to the emitter in order.
 
             struct DecodeEntry
             {
@@ -2435,6 +3115,11 @@ namespace JS8
                 int & kpos;
                 int & ksz;
 
+                std::vector<Event::Variant> events;
+                std::size_t                 decoded   = 0;
+                bool                        scheduled = false;
+                bool                        done      = false;
+
                 template <typename DecodeModeType>
                 DecodeEntry(std::in_place_type_t<DecodeModeType>,
                             int   mode,
@@ -2451,8 +3136,9 @@ namespace JS8
             // instantiate them in-place. Note that with the advent of the
             // multi-decoder, mode identifiers became a bitset instead of
             // integral values. The order defined here is the order that
-            // the decode loop will run in; we're matching the Fortran
-            // version here in terms of faster modes first.
+            // decodes will be dispatched in, and the order in which their
+            // events will be emitted; we're matching the Fortran version
+            // here in terms of faster modes first.
 
             template <typename ModeType>
             DecodeEntry makeDecodeEntry(int   shift,
@@ -2467,20 +3153,72 @@ namespace JS8
 
             std::array<DecodeEntry, 5> m_decodes =
             {{
-                makeDecodeEntry<ModeI>(4, m_data.params.kposI, m_data.params.kszI),
-                makeDecodeEntry<ModeE>(3, m_data.params.kposE, m_data.params.kszE),
-                makeDecodeEntry<ModeC>(2, m_data.params.kposC, m_data.params.kszC),
-                makeDecodeEntry<ModeB>(1, m_data.params.kposB, m_data.params.kszB),
-                makeDecodeEntry<ModeA>(0, m_data.params.kposA, m_data.params.kszA)
+                makeDecodeEntry<ModeI>(4, m_snapshot.params.kposI, m_snapshot.params.kszI),
+                makeDecodeEntry<ModeE>(3, m_snapshot.params.kposE, m_snapshot.params.kszE),
+                makeDecodeEntry<ModeC>(2, m_snapshot.params.kposC, m_snapshot.params.kszC),
+                makeDecodeEntry<ModeB>(1, m_snapshot.params.kposB, m_snapshot.params.kszB),
+                makeDecodeEntry<ModeA>(0, m_snapshot.params.kposA, m_snapshot.params.kszA)
             }};
 
+            // Completion of decode entries is signaled through the condition
+            // variable, guarded by the mutex. Decode entries are run by the
+            // mode pool, and may in turn farm out candidates to the candidate
+            // pool; see pools() below. We don't return from a decoding pass
+            // until every entry we dispatched has signaled completion, and
+            // an entry doesn't touch us after doing so, so it's safe for us
+            // to go away without waiting on the pools.
+
+            std::mutex              m_mutex;
+            std::condition_variable m_condition;
+
+            // The decoder thread pools are shared by every Worker in the
+            // process, such that the decoders of multiple receivers compete
+            // for a fixed set of threads, rather than each having a set of
+            // its own. These must be distinct pools, as decode entry tasks
+            // block on the candidate tasks, which never block. The pools are
+            // fixed in size; threads never expire, so that we're not paying
+            // for thread creation on every decoding pass. A thread decoding
+            // a mode participates in decoding its candidates, so the
+            // candidate pool needs one less than the ideal count. They're
+            // created by the first Worker to run, on its thread, so their
+            // threads inherit its priority.
+
+            struct Pools
+            {
+                QThreadPool modes;
+                QThreadPool candidates;
+
+                Pools()
+                {
+                    auto const threads  = QThread::idealThreadCount();
+                    auto const priority = QThread::currentThread()->priority();
+
+                    modes.setMaxThreadCount(std::max(threads, 1));
+                    candidates.setMaxThreadCount(std::max(threads - 1, 1));
+
+                    for (auto pool : {&modes, &candidates})
+                    {
+                        pool->setExpiryTimeout(-1);
+                        pool->setThreadPriority(priority);
+                    }
+                }
+            };
+
+            static Pools & pools()
+            {
+                static Pools pools;
+                return pools;
+            }
+
         public:
 
-            // Constructor
+            // Constructor; we're running on the worker thread at this point.
 
-            explicit Impl(struct dec_data & data)
-            : m_data(data)
-            {}
+            explicit Impl(Snapshot & snapshot)
+            : m_snapshot(snapshot)
+            {
+                pools();
+            }
 
             // Execute a decoding pass, using the supplied event emitter to
             // emit events as they occur.
@@ -2491,7 +3229,7 @@ namespace JS8
                 // the same time; specific decodes to be performed for this
                 // pass are in the `nsubmodes` bitset.
 
-                auto const  set = m_data.params.nsubmodes;
+                auto const  set = m_snapshot.params.nsubmodes;
                 std::size_t sum = 0;
 
                 // Let any interested parties know that we've started a run
@@ -2499,21 +3237,61 @@ namespace JS8
 
                 emitEvent(Event::DecodeStarted{set});
 
-                // Iterate through all the modes we're aware of, performing
-                // a mode-specific decode pass if the mode is scheduled for
-                // decoding during this pass.
+                // Dispatch a mode-specific decode task to the pool for each
+                // of the modes scheduled for decoding during this pass. The
+                // decode data is read-only during the pass, and each entry
+                // is touched by only one task, so the tasks share nothing.
 
                 for (auto & entry : m_decodes)
                 {
-                    if ((set & entry.mode) == entry.mode)
+                    entry.events.clear();
+                    entry.decoded   = 0;
+                    entry.scheduled = (set & entry.mode) == entry.mode;
+                    entry.done      = false;
+
+                    if (!entry.scheduled) continue;
+
+                    pools().modes.start([this, &entry]()
                     {
-                        std::visit([&](auto && decode) {
-                            sum += decode(m_data,
+                        auto const decoded = std::visit([&](auto && decode)
+                        {
+                            return decode(m_snapshot,
                                           entry.kpos,
                                           entry.ksz,
-                                          emitEvent);
+                                          JS8_DECODE_PARALLEL ? &pools().candidates : nullptr,
+                                          [&entry](Event::Variant const & event)
+                                          {
+                                              entry.events.push_back(event);
+                                          });
                         }, entry.decode);
-                    }
+
+                        // Notify while holding the lock; once we release
+                        // it, the pass may complete and we may be gone.
+
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        entry.decoded = decoded;
+                        entry.done    = true;
+                        m_condition.notify_one();
+                    });
+                }
+
+                // Release events to the emitter in dispatch order, on this
+                // thread, as each entry completes; an entry's events can't
+                // be emitted until all entries ahead of it have been, so the
+                // sequence seen by the caller is the same as that of a serial
+                // decode, regardless of the order in which tasks complete.
+
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                for (auto & entry : m_decodes)
+                {
+                    if (!entry.scheduled) continue;
+
+                    m_condition.wait(lock, [&entry] { return entry.done; });
+
+                    for (auto const & event : entry.events) emitEvent(event);
+
+                    sum += entry.decoded;
                 }
 
                 // Let any interested parties know the total number of decodes
@@ -2525,19 +3303,26 @@ namespace JS8
 
         // Data members
 
-        QSemaphore      * m_semaphore;
-        std::atomic<bool> m_quit = false;
-        struct dec_data   m_data;
+        dec_data   const & m_data;
+        QSemaphore       * m_semaphore;
+        std::atomic<bool>  m_quit = false;
+        Snapshot           m_snapshot;
 
     public:
 
-        // Constructor
+        // Constructor; decodes are of the sample buffer of the receiver
+        // data provided.
 
-        explicit Worker(QSemaphore * semaphore,
-                        QObject    * parent = nullptr)
+        Worker(dec_data   const & data,
+               QSemaphore       * semaphore,
+               QObject          * parent = nullptr)
         : QObject    (parent)
+        , m_data     (data)
         , m_semaphore(semaphore)
-        {}
+        {
+            m_snapshot.d2      = m_data.d2;
+            m_snapshot.d2epoch = &m_data.epoch;
+        }
 
         // Used to inform the worker that it's time to go; the next
         // time it wakes up due to the semaphore being released, it
@@ -2548,12 +3333,16 @@ namespace JS8
             m_quit = true;
         }
 
-        // Called by the owning Decoder to refresh the copy of the
-        // decode data that the Worker implementation references.
+        // Called by the owning Decoder, with the Detector mutex held, to
+        // refresh the snapshot that the Worker implementation references.
+        // This is just the decode parameters and the buffer epoch; samples
+        // are read in place by the decoder, so they're not copied here.
 
         void copy()
         {
-            m_data = dec_data;
+            m_snapshot.params    = m_data.params;
+            m_snapshot.epoch     = m_data.epoch.load(std::memory_order_acquire);
+            m_snapshot.requested = std::chrono::steady_clock::now();
         };
 
     signals:
@@ -2578,7 +3367,7 @@ namespace JS8
             // can take a while. We only need the implementation while
             // we're running.
 
-            std::unique_ptr<Impl> impl = std::make_unique<Impl>(m_data);
+            std::unique_ptr<Impl> impl = std::make_unique<Impl>(m_snapshot);
 
             // Wait until there's something that requires our attention,
             // which is going to either be needing to quit or needing to
@@ -2607,10 +3396,11 @@ namespace JS8
 
 namespace JS8
 {
-    Decoder::Decoder(QObject * parent)
+    Decoder::Decoder(dec_data const & data,
+                     QObject        * parent)
     : QObject(parent)
     , m_semaphore(0)
-    , m_worker(new Worker(&m_semaphore))
+    , m_worker(new Worker(data, &m_semaphore))
     {
         m_worker->moveToThread(&m_thread);
 
@@ -2642,6 +3432,111 @@ namespace JS8
     }
 }
 
+/******************************************************************************/
+// Public Interface - Offline Decoding
+/******************************************************************************/
+
+namespace JS8
+{
+    // Offline decoding runs the same decode strategies as the Worker, in the
+    // same order, but serially, against a private sample buffer. Since that
+    // buffer is never modified during a decode, the epoch serves only to let
+    // the strategies know that each decode is of new samples, and therefore
+    // that nothing retained from a prior decode applies.
+
+    class OfflineDecoder::Impl
+    {
+        std::atomic<std::uint32_t> m_epoch = 0;
+        std::tuple<
+            DecodeMode<ModeI>,
+            DecodeMode<ModeE>,
+            DecodeMode<ModeC>,
+            DecodeMode<ModeB>,
+            DecodeMode<ModeA>
+        >                          m_decodes;
+
+        // Submode bits within the nsubmodes bitset are in the order of the
+        // submode identifiers; normal mode's identifier is zero.
+
+        template <typename ModeType>
+        static constexpr int bit(DecodeMode<ModeType> const &)
+        {
+            return ModeType::NSUBMODE ? ModeType::NSUBMODE << 1 : 1;
+        }
+
+        template <typename ModeType>
+        static constexpr int frames(DecodeMode<ModeType> const &)
+        {
+            return ModeType::NMAX;
+        }
+
+    public:
+
+        std::size_t
+        operator()(std::int16_t const * const samples,
+                   int                  const size,
+                   Parameters           const & parameters,
+                   Event::Emitter               emitEvent,
+                   Timings                    * timings)
+        {
+            Snapshot    snapshot = {};
+            std::size_t sum      = 0;
+
+            snapshot.params.nutc      = parameters.nutc;
+            snapshot.params.nfqso     = parameters.nfqso;
+            snapshot.params.nfa       = parameters.nfa;
+            snapshot.params.nfb       = parameters.nfb;
+            snapshot.params.minsum    = parameters.minsum;
+            snapshot.params.syncOnly  = parameters.syncOnly;
+            snapshot.params.stats     = parameters.stats;
+            snapshot.params.nsubmodes = parameters.nsubmodes;
+            snapshot.epoch            = m_epoch.fetch_add(2, std::memory_order_relaxed) + 2;
+            snapshot.requested        = std::chrono::steady_clock::now();
+            snapshot.d2               = samples;
+            snapshot.d2epoch          = &m_epoch;
+
+            emitEvent(Event::DecodeStarted{parameters.nsubmodes});
+
+            std::apply([&](auto & ... decode)
+            {
+                auto const run = [&](auto & decode)
+                {
+                    if ((parameters.nsubmodes & bit(decode)) == 0) return;
+
+                    sum += decode(snapshot,
+                                  0,
+                                  std::clamp(size, 0, frames(decode)),
+                                  nullptr,
+                                  emitEvent,
+                                  timings);
+                };
+
+                (run(decode), ...);
+            }, m_decodes);
+
+            emitEvent(Event::DecodeFinished{sum});
+
+            return sum;
+        }
+    };
+
+    OfflineDecoder::OfflineDecoder()
+    : m_impl(std::make_unique<Impl>())
+    {}
+
+    OfflineDecoder::~OfflineDecoder() = default;
+
+    std::size_t
+    OfflineDecoder::decode(std::int16_t const * const   samples,
+                           int                  const   size,
+                           Parameters           const & parameters,
+                           Event::Emitter               emitEvent,
+                           Timings            * const   timings)
+    {
+        return (*m_impl)(samples, size, parameters, std::move(emitEvent), timings);
+    }
+}
+
 /******************************************************************************/
 // Public Interface - Encoding
 /******************************************************************************/
@@ -2797,3 +3692,100 @@ namespace JS8
 }
 
 /******************************************************************************/
+// Testing Interface
+/******************************************************************************/
+
+#ifdef JS8_TESTING
+namespace
+{
+    template <typename Mode>
+    bool
+    subtractAs(int                  const   submode,
+               std::int16_t const * const   samples,
+               int                  const   size,
+               std::array<int, NN>  const & itone,
+               float                const   frequency,
+               float                const   dt,
+               JS8::Testing::Subtraction  & result)
+    {
+        if (submode != Mode::NSUBMODE) return false;
+
+        std::make_unique<DecodeMode<Mode>>()->subtract(samples, size, itone, frequency, dt, result);
+
+        return true;
+    }
+}
+
+namespace JS8::Testing
+{
+    std::vector<std::complex<float>>
+    subtractionTaps()
+    {
+        std::vector<std::complex<float>> taps(NFILT + 1);
+
+        ::subtractionTaps(taps.data());
+
+        return taps;
+    }
+
+    Subtraction
+    subtract(int                  const   submode,
+             std::int16_t const * const   samples,
+             int                  const   size,
+             int          const * const   tones,
+             float                const   frequency,
+             float                const   dt)
+    {
+        std::array<int, NN> itone;
+        Subtraction         result;
+
+        std::copy(tones, tones + NN, itone.begin());
+
+        subtractAs<ModeA>(submode, samples, size, itone, frequency, dt, result) ||
+        subtractAs<ModeB>(submode, samples, size, itone, frequency, dt, result) ||
+        subtractAs<ModeC>(submode, samples, size, itone, frequency, dt, result) ||
+        subtractAs<ModeE>(submode, samples, size, itone, frequency, dt, result) ||
+        subtractAs<ModeI>(submode, samples, size, itone, frequency, dt, result);
+
+        return result;
+    }
+
+    float
+    syncThreshold()
+    {
+        return ASYNCMIN;
+    }
+
+    std::size_t
+    maxCandidates()
+    {
+        return NMAXCAND;
+    }
+
+    std::vector<Candidate>
+    candidates(std::vector<float> const & freq,
+               std::vector<float> const & step,
+               std::vector<float> const & sync,
+               float              const   az)
+    {
+        static SyncBuffer buffer;
+
+        buffer.clear();
+
+        for (std::size_t i = 0; i < freq.size(); ++i) buffer.emplace(freq[i], step[i], sync[i]);
+
+        if (buffer.empty()) return {};
+
+        std::vector<Candidate> result;
+
+        for (auto const & candidate : buffer.candidates(az))
+        {
+            result.push_back({candidate.freq, candidate.step, candidate.sync});
+        }
+
+        return result;
+    }
+}
+#endif
+
+/******************************************************************************/
@@ -2,13 +2,18 @@
 #define __JS8
 
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <variant>
 #include <QObject>
 #include <QSemaphore>
 #include <QThread>
 
+struct dec_data;
+
 namespace JS8
 {
   Q_NAMESPACE
@@ -58,6 +63,37 @@ namespace JS8
          const char          * message,
          int                 * tones);
 
+  // Time spent decoding, in each of the decoding passes and in each of
+  // the principal stages of decoding, summed over all submodes and all
+  // candidates decoded. Candidates may be decoded concurrently, in which
+  // case stage times may sum to more than pass times.
+
+  struct Timings
+  {
+    using Duration = std::chrono::nanoseconds;
+
+    std::array<Duration, 3> passes     = {};
+    Duration                sync       = {};  // Symbol spectra and sync search
+    Duration                candidates = {};  // Candidate selection, included in sync
+    Duration                downsample = {};  // Candidate downsampling
+    Duration                bpdecode   = {};  // LDPC decoding
+    Duration                subtract   = {};  // Subtraction of decoded signals
+
+    Timings &
+    operator+=(Timings const & other)
+    {
+      for (std::size_t i = 0; i < passes.size(); ++i) passes[i] += other.passes[i];
+
+      sync       += other.sync;
+      candidates += other.candidates;
+      downsample += other.downsample;
+      bpdecode   += other.bpdecode;
+      subtract   += other.subtract;
+
+      return *this;
+    }
+  };
+
   namespace Event
   {
     struct DecodeStarted
@@ -99,6 +135,34 @@ namespace JS8
       int         mode;
     };
 
+    // When decoding early, a submode has candidates whose frames will be
+    // complete once the window starting at the position contains at least
+    // the provided number of frames.
+
+    struct DecodePending
+    {
+      int mode;
+      int position;
+      int size;
+    };
+
+    // When requested, the decode of each submode concludes with counts
+    // of what was done, by pass, and the time taken to do it; lag is the
+    // time from the request for the decode to the start of the submode's
+    // decode, i.e., the time spent waiting on the decoder.
+
+    struct Stats
+    {
+      int                      mode;
+      std::chrono::nanoseconds lag;
+      Timings                  timings;
+      std::array<int, 3>       candidates;    // Candidates decoded
+      std::array<int, 3>       decoded;       // New or improved decodes
+      int                      bpDecodes;     // Invocations of the LDPC decoder
+      int                      bpCodewords;   // Codewords presented to the LDPC decoder
+      int                      bpIterations;  // Iterations performed by the LDPC decoder
+    };
+
     struct DecodeFinished
     {
       std::size_t decoded;
@@ -108,6 +172,8 @@ namespace JS8
                                  SyncStart,
                                  SyncState,
                                  Decoded,
+                                 DecodePending,
+                                 Stats,
                                  DecodeFinished>;
 
     using Emitter = std::function<void(Variant const &)>;
@@ -115,6 +181,10 @@ namespace JS8
 
   class Worker;
 
+  // Asynchronous decoder, for live audio; decodes the sample buffer of a
+  // receiver on a thread of its own. Any number of these may be in use,
+  // one per receiver, in which case they share the decoder thread pools.
+
   class Decoder: public QObject
   {
     Q_OBJECT
@@ -124,8 +194,11 @@ namespace JS8
     Worker   * m_worker;
 
   public:
-      
-    Decoder(QObject * parent = nullptr);
+
+    // Constructor; the receiver data must outlive us.
+
+    explicit Decoder(dec_data const & data,
+                     QObject        * parent = nullptr);
 
   signals:
 
@@ -137,6 +210,49 @@ namespace JS8
     void quit();
     void decode();
   };
+
+  // Synchronous decoder, for tools that decode recorded audio rather than
+  // live audio. Decoding is performed on the calling thread, using neither
+  // the sample buffer of a receiver nor any thread pools, so any number of
+  // these may be in use concurrently, one per thread.
+
+  class OfflineDecoder
+  {
+  public:
+
+    struct Parameters
+    {
+      int  nsubmodes;          // Submodes to decode, as a bitset
+      int  nutc      = 0;      // Time of the first sample, per code_time()
+      int  nfqso     = 1500;   // QSO frequency (Hz); decoded first
+      int  nfa       = 0;      // Low decode limit (Hz)
+      int  nfb       = 5000;   // High decode limit (Hz)
+      bool minsum    = false;  // Use the min-sum LDPC decoder
+      bool syncOnly  = false;  // Stop after the first sync search, for benchmarking
+      bool stats     = false;  // Emit a Stats event for each submode decoded
+    };
+
+    OfflineDecoder();
+    ~OfflineDecoder();
+
+    // Decode 12kHz samples, the first of which must be at the start of
+    // a period, for each of the requested submodes; samples beyond the
+    // length of a submode's period are ignored for that submode. Events
+    // are emitted as they would be by the Decoder, on the calling thread,
+    // and the number of unique decodes is returned. If timings are given,
+    // the time spent decoding is added to them.
+
+    std::size_t decode(std::int16_t const * samples,
+                       int                  size,
+                       Parameters   const & parameters,
+                       Event::Emitter       emitEvent,
+                       Timings            * timings = nullptr);
+
+  private:
+
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
 }
 
 #endif
@@ -68,6 +68,7 @@ namespace JS8::Submode
         m_rxSNRThreshold  (rxSNRThreshold),
         m_rxThreshold     (rxThreshold),
         m_framesForSymbols(   JS8_NUM_SYMBOLS * symbolSamples),
+        m_framesForCostas (   (7 + 36)        * symbolSamples),
         m_bandwidth       (8 * JS8_RX_SAMPLE_RATE / symbolSamples),
         m_framesPerCycle  (    JS8_RX_SAMPLE_RATE * txSeconds),
         m_toneSpacing     (    JS8_RX_SAMPLE_RATE / (double)symbolSamples),
@@ -86,6 +87,7 @@ namespace JS8::Submode
       constexpr auto rxSNRThreshold()   const { return m_rxSNRThreshold;   }
       constexpr auto rxThreshold()      const { return m_rxThreshold;      }
       constexpr auto framesForSymbols() const { return m_framesForSymbols; }
+      constexpr auto framesForCostas()  const { return m_framesForCostas;  }
       constexpr auto bandwidth()        const { return m_bandwidth;        }
       constexpr auto framesPerCycle()   const { return m_framesPerCycle;   }
       constexpr auto framesNeeded()     const { return m_framesNeeded;     }
@@ -105,6 +107,7 @@ namespace JS8::Submode
       int          m_rxSNRThreshold;
       int          m_rxThreshold;
       int          m_framesForSymbols;
+      int          m_framesForCostas;
       int          m_bandwidth;
       int          m_framesPerCycle;
       double       m_toneSpacing;
@@ -178,6 +181,7 @@ namespace JS8::Submode
   Costas::Type costas          (int const submode) { return data(submode).costas();           }
   unsigned int framesPerCycle  (int const submode) { return data(submode).framesPerCycle();   }
   unsigned int framesForSymbols(int const submode) { return data(submode).framesForSymbols(); }
+  unsigned int framesForCostas (int const submode) { return data(submode).framesForCostas();  }
   unsigned int framesNeeded    (int const submode) { return data(submode).framesNeeded();     }
   unsigned int period          (int const submode) { return data(submode).period();           }
   int          rxSNRThreshold  (int const submode) { return data(submode).rxSNRThreshold();   }
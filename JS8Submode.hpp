@@ -27,6 +27,7 @@ namespace JS8::Submode
   Costas::Type costas(int);
   unsigned int framesPerCycle(int);
   unsigned int framesForSymbols(int);
+  unsigned int framesForCostas(int);
   unsigned int framesNeeded(int);
   unsigned int period(int);
   int          rxSNRThreshold(int);
@@ -0,0 +1,368 @@
+#include "SpectrumEngine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "commons.h"
+#include "JS8Submode.hpp"
+
+/******************************************************************************/
+// Local Routines
+/******************************************************************************/
+
+namespace
+{
+  // Size of the sample buffer, and the count of frames it must contain
+  // before we'll compute anything from it.
+
+  constexpr int NMAX    = JS8_NTMAX * JS8_RX_SAMPLE_RATE;
+  constexpr int MINIMUM = 2048;
+
+  // Smoothing widths selectable for the linear average spectrum.
+
+  constexpr std::array NCH = {1, 2, 4, 9, 18, 36, 72};
+
+  // Emulation of the Fortran 'flat1' subroutine.
+
+  void
+  flat1(float const * const savg,
+        int           const iz,
+        int           const nsmo,
+        float       * const slin)
+  {
+    constexpr int x_size = 8192;
+    constexpr int nstep  = 20;
+    constexpr int nh     = nstep / 2;
+
+    // Define bounds for smoothing
+    int const ia =      nsmo / 2 + 1;
+    int const ib = iz - nsmo / 2 - 1;
+
+    std::vector<float> x(x_size, 0.0f);
+
+    // Smooth savg using median percentiles
+
+    auto const rank = std::clamp(static_cast<int>(std::round(0.5f * nsmo)), 0, nsmo - 1);
+
+    for (int i = ia; i <= ib; i += nstep)
+    {
+      auto const data = &savg[i - nsmo / 2];
+      auto       temp = std::vector<float>(data, data + nsmo);
+
+      std::nth_element(temp.begin(),
+                       temp.begin() + rank,
+                       temp.end());
+
+      x[i] = temp[rank];
+
+      std::fill(x.begin() + (i - nh),
+                x.begin() + (i + nh), x[i]);
+    }
+
+    // Extend smoothed values to boundaries
+    std::fill(x.begin(),          x.begin() + ia, x[ia]);
+    std::fill(x.begin() + ib + 1, x.begin() + iz, x[ib]);
+
+    // Compute scaling factor
+    float x0 = 0.001f * *std::max_element(x.begin() +      iz  / 10,
+                                          x.begin() + (9 * iz) / 10);
+
+    // Normalize savg to compute slin
+    for (int i = 0; i < iz; ++i) slin[i] = savg[i] / (x[i] + x0);
+  }
+
+  // Emulation of the Fortran 'smo' subroutine. However, doesn't copy the data
+  // back from b to a; rather, a is input and, b is output. Since we invariably
+  // call this twice, we can just swap the order of the arrays to achieve the
+  // same result without the extra two copy operations.
+
+  void
+  smo(float const * const a,
+      float       * const b,
+      int           const npts,
+      int           const nadd)
+  {
+    auto const nh = nadd / 2;
+
+    // Smooth the array
+    for (int i = nh; i < npts - nh; ++i)
+    {
+      float sum = 0.0f;
+      for (int j = -nh; j <= nh; ++j)
+      {
+        sum += a[i + j];
+      }
+      b[i] = sum;
+    }
+
+    // Set edges to zero
+    for (int i = 0;         i < nh;   ++i) b[i] = 0.0f; // Zero out leading edge
+    for (int i = npts - nh; i < npts; ++i) b[i] = 0.0f; // Zero out trailing edge
+  }
+}
+
+/******************************************************************************/
+// Implementation
+/******************************************************************************/
+
+#include "moc_SpectrumEngine.cpp"
+
+SpectrumEngine::SpectrumEngine(dec_data      & decData,
+                               QObject * const parent)
+  : QObject   (parent)
+  , m_decData (decData)
+  , m_submode (0)
+{
+  prepareWindow(m_windowType);
+}
+
+void
+SpectrumEngine::setSubmode(int const submode)
+{
+  m_submode.store(submode, std::memory_order_relaxed);
+}
+
+// Takes the smoothing as presented by the wide graph, i.e., 1-based.
+
+void
+SpectrumEngine::setSmoothing(int const smoothing)
+{
+  m_smoothing.store(std::clamp(smoothing - 1, 0, static_cast<int>(NCH.size()) - 1),
+                    std::memory_order_relaxed);
+}
+
+void
+SpectrumEngine::setStep(int const step)
+{
+  m_step.store(std::clamp(step, 1, NFFT), std::memory_order_relaxed);
+}
+
+void
+SpectrumEngine::setWindow(Window const window)
+{
+  m_windowNext.store(window, std::memory_order_relaxed);
+}
+
+// Compute the window coefficients, normalized to unity mean, so that the
+// level of the spectrum is about the same regardless of the window. The
+// scaling of the samples to the range the display expects is folded in.
+
+void
+SpectrumEngine::prepareWindow(Window const window)
+{
+  constexpr double pi = std::numbers::pi;
+
+  for (int i = 0; i < NFFT; ++i)
+  {
+    double const x = static_cast<double>(i) / NFFT;
+
+    switch (window)
+    {
+      case Window::Rectangular:
+        m_window[i] = 1.0f;
+        break;
+
+      case Window::Hann:
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2 * pi * x));
+        break;
+
+      case Window::Nuttall:
+        m_window[i] = static_cast<float>(0.3635819
+                                       - 0.4891775 * std::cos(2 * pi * x)
+                                       + 0.1365995 * std::cos(4 * pi * x)
+                                       - 0.0106411 * std::cos(6 * pi * x));
+        break;
+    }
+  }
+
+  double sum = 0.0;
+
+  for (auto const value : m_window) sum += value;
+
+  auto const scale = static_cast<float>(0.1 * NFFT / sum);
+
+  for (auto & value : m_window) value *= scale;
+
+  m_windowType = window;
+}
+
+// Process a block of frames written to the sample buffer; the Detector
+// tells us how many frames it now contains. Spectra are computed over
+// the NFFT frames preceding each step boundary reached, normally just
+// the one, since the Detector writes in blocks of the default step size,
+// but there may be more or fewer if the step's been changed. If we're
+// somehow far enough behind that the ring would overflow, we skip ahead
+// to the latest frame, as we also do when the buffer position jumps.
+
+void
+SpectrumEngine::process(qint64 const frames)
+{
+  int  const k       = static_cast<int>(frames);
+  auto const submode = m_submode.load(std::memory_order_relaxed);
+  auto const step    = m_step.load(std::memory_order_relaxed);
+
+  if (auto const window  = m_windowNext.load(std::memory_order_relaxed);
+                 window != m_windowType) prepareWindow(window);
+
+  if (!m_started)
+  {
+    m_started = true;
+    m_ihsym   = k / JS8_NSPS * 2;
+    m_next    = k;
+    m_k0      = k;
+  }
+
+  // Make sure the average is reset every period cycle, and cap the count
+  // of spectra in it based on the period.
+
+  if (auto const cycle  = JS8::Submode::computeCycleForDecode(submode, k);
+                 cycle != m_cycle)
+  {
+    m_ssum.fill(0.0f);
+    m_cycle = cycle;
+  }
+
+  m_ihsym %= JS8::Submode::period(submode) * JS8_RX_SAMPLE_RATE / JS8_NSPS * 2;
+
+  if (k < MINIMUM || k > NMAX)
+  {
+    if (k < MINIMUM) m_ihsym = 0;
+    m_next = k;
+    return;
+  }
+
+  // If the buffer has wrapped, start a new data block. Anything past the
+  // write position left over from the previous one is cleared by the main
+  // window, before it considers decoding.
+
+  if (k < m_k0)
+  {
+    m_ssum.fill(0.0f);
+    m_ihsym = 0;
+    m_next  = k;
+    m_sq    = 0.0f;
+    m_peak  = 0.0f;
+    m_count = 0;
+    m_k0    = 0;
+  }
+
+  // Accumulate power and peak of the new samples for the meter.
+
+  for (int i = m_k0; i < k; ++i)
+  {
+    float const x = m_decData.d2[i];
+    m_peak        = std::max(m_peak, std::fabs(x));
+    m_sq         += x * x;
+  }
+
+  m_count += std::max(0, k - m_k0);
+  m_k0     = k;
+
+  if (k - m_next >= static_cast<int>(m_ring.size()) * step) m_next = k;
+
+  while (m_next <= k)
+  {
+    analyze(m_next);
+    publish(k);
+    m_next += step;
+  }
+}
+
+// Compute the spectrum of the NFFT frames preceding the end position,
+// and update the averages. The plan comes from the registry, created on
+// a background thread at startup; if that's somehow not yet complete,
+// we'll wait for it, but we'll never plan here.
+
+void
+SpectrumEngine::analyze(int const end)
+{
+  if (!m_plan) m_plan = FFTW::plan({FFTW::Kind::R2C, NFFT});
+
+  auto const real = reinterpret_cast<float *>(m_data.data());
+
+  for (int i = 0; i < NFFT; ++i)
+  {
+    int const j = end + i - NFFT;
+
+    real[i] = j >= 0 && j < NMAX ? m_window[i] * m_decData.d2[j] : 0.0f;
+  }
+
+  ++m_ihsym;
+
+  m_plan.execute(m_data.data());
+
+  // Process the resulting spectrum.
+
+  constexpr float df  = static_cast<float>(JS8_RX_SAMPLE_RATE) / NFFT;
+  constexpr int   iz  = std::min(JS8_NSMAX, static_cast<int>(5000.0f / df));
+  constexpr float fac = 1.0f / (static_cast<float>(NFFT) * NFFT);
+
+  for (int i = 0; i < iz; ++i)
+  {
+    auto const sx = fac * std::norm(m_data[i]);
+    m_ssum[i]    += sx;
+    m_s[i]        = 1000.0f * sx;
+  }
+
+  // Update average spectra.
+
+  for (int i = 0; i < iz; ++i) m_savg[i] = m_ssum[i] / m_ihsym;
+
+  if ((m_linear = m_ihsym % 10 == 0))
+  {
+    auto const mode4 = NCH[m_smoothing.load(std::memory_order_relaxed)];
+    auto const nsmo  = 4 * std::min(10 * mode4, 150);
+
+    flat1(m_savg.data(), iz, nsmo, m_slin.data());
+
+    if (mode4 >= 2)
+    {
+      WF::SPlot tmp;
+
+      smo(m_slin.data(), tmp.data(),    iz, mode4);
+      smo(tmp.data(),    m_slin.data(), iz, mode4);
+    }
+
+    std::fill(m_slin.begin(), m_slin.begin() + 250, 0.0f);
+
+    auto const ia    = static_cast<int>( 500.0 / df);
+    auto const ib    = static_cast<int>(2700.0 / df);
+    auto const smin  = *std::min_element(m_slin.begin() + ia, m_slin.begin() + ib);
+    auto const smax  = *std::max_element(m_slin.begin(),      m_slin.begin() + iz);
+    auto const scale = (smax > smin) ? 50.0f / (smax - smin) : 0.0f;
+
+    for (auto & val : m_slin) val = std::max(0.0f, scale * (val - smin));
+  }
+}
+
+// Publish the current state to the ring, if there's room in it, and let
+// the consumer know, if it's not already been told, that there's data.
+
+void
+SpectrumEngine::publish(qint64 const k)
+{
+  auto const tail = m_tail.load(std::memory_order_relaxed);
+
+  if (tail - m_head.load(std::memory_order_acquire) < m_ring.size())
+  {
+    auto & frame = m_ring[tail % m_ring.size()];
+
+    frame.k      = k;
+    frame.df     = static_cast<float>(JS8_RX_SAMPLE_RATE) / NFFT;
+    frame.px     = m_sq   > 0.0f ? 10.0f * std::log10(m_sq / m_count) : 0.0f;
+    frame.pxmax  = m_peak > 0.0f ? 20.0f * std::log10(m_peak)         : 0.0f;
+    frame.linear = m_linear;
+    frame.s      = m_s;
+    frame.savg   = m_savg;
+
+    if (m_linear) frame.slin = m_slin;
+
+    m_tail.store(tail + 1, std::memory_order_release);
+  }
+
+  m_sq    = 0.0f;
+  m_peak  = 0.0f;
+  m_count = 0;
+
+  if (!m_notified.exchange(true, std::memory_order_acq_rel)) Q_EMIT framesReady();
+}
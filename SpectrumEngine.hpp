@@ -0,0 +1,140 @@
+#ifndef SPECTRUM_ENGINE_HPP__
+#define SPECTRUM_ENGINE_HPP__
+
+#include <array>
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <QObject>
+#include "FFTW.hpp"
+#include "WF.hpp"
+
+struct dec_data;
+
+// Computes the spectra displayed by the waterfall from the samples that
+// the Detector writes to the sample buffer of the receiver. Runs on a thread of
+// its own, driven by the Detector's framesWritten() signal, and owns the
+// buffers and plan it needs for the duration.
+//
+// Each spectrum computed is published through a single-producer, single-
+// consumer ring; the consumer is told that there's something in it via
+// the framesReady() signal, which is emitted only when the consumer has
+// drained everything it was told about previously, and drains it at its
+// leisure, on its own thread. If the consumer falls behind to the point
+// that the ring is full, frames are dropped, rather than holding up the
+// analysis.
+
+class SpectrumEngine : public QObject
+{
+  Q_OBJECT
+
+public:
+
+  // Size of the FFT used to compute spectra, and the default number of
+  // frames between successive spectra, i.e., the size of the FFT less
+  // the overlap between them.
+
+  static constexpr int NFFT = 16384;
+  static constexpr int STEP = JS8_NSPS / 2;
+
+  // Window applied to samples prior to the FFT; rectangular is none.
+
+  enum class Window
+  {
+    Rectangular,
+    Hann,
+    Nuttall
+  };
+
+  // A spectrum, along with everything else computed from the samples
+  // since the previous one.
+
+  struct Frame
+  {
+    qint64    k;       // Frames in the sample buffer at the time
+    float     df;      // Resolution of the spectrum, in Hz per bin
+    float     px;      // Power of the samples since the last frame, in dB
+    float     pxmax;   // Peak of the samples since the last frame, in dB
+    bool      linear;  // Set if slin was recomputed for this frame
+    WF::SPlot s;       // Current spectrum
+    WF::SPlot savg;    // Average spectrum over the period
+    WF::SPlot slin;    // Flattened and smoothed average spectrum
+  };
+
+  // Constructor; the receiver data is that the Detector writes to. We
+  // only ever read from it; anything that modifies it must be ordered
+  // with respect to the decoder, which we're not.
+
+  SpectrumEngine(dec_data & decData,
+                 QObject  * parent = nullptr);
+
+  // Manipulators; may be called from any thread, and take effect as of
+  // the next block of frames processed.
+
+  void setSubmode  (int);
+  void setSmoothing(int);
+  void setStep     (int);
+  void setWindow   (Window);
+
+  // Consume every frame in the ring, oldest first; for use only by the
+  // consumer, i.e., in response to framesReady().
+
+  template <typename Consume>
+  void
+  drain(Consume && consume)
+  {
+    m_notified.store(false, std::memory_order_release);
+
+    for (auto head  = m_head.load(std::memory_order_relaxed);
+              head != m_tail.load(std::memory_order_acquire);
+            ++head)
+    {
+      consume(static_cast<Frame const &>(m_ring[head % m_ring.size()]));
+      m_head.store(head + 1, std::memory_order_release);
+    }
+  }
+
+  // Signals and slots
+
+  Q_SLOT   void process(qint64 frames);
+  Q_SIGNAL void framesReady() const;
+
+private:
+
+  void analyze(int end);
+  void publish(qint64 k);
+  void prepareWindow(Window);
+
+  // Data members; the work area is aligned such that the library can
+  // use SIMD instructions on it, and provides room for an extra complex
+  // value so that the same buffer serves for the FFT input and output.
+
+  dec_data                                            & m_decData;
+  FFTW::Plan                                            m_plan;
+  alignas(64) std::array<std::complex<float>, NFFT / 2 + 1> m_data;
+  std::array<float, NFFT>                               m_window;
+  Window                                                m_windowType = Window::Rectangular;
+  std::array<Frame, 8>                                  m_ring;
+  std::atomic<std::size_t>                              m_head       = 0;
+  std::atomic<std::size_t>                              m_tail       = 0;
+  std::atomic<bool>                                     m_notified   = false;
+  std::atomic<int>                                      m_submode;
+  std::atomic<int>                                      m_smoothing  = 0;
+  std::atomic<int>                                      m_step       = STEP;
+  std::atomic<Window>                                   m_windowNext = Window::Rectangular;
+  WF::SPlot                                             m_s          = {};
+  WF::SPlot                                             m_ssum       = {};
+  WF::SPlot                                             m_savg       = {};
+  WF::SPlot                                             m_slin       = {};
+  bool                                                  m_linear     = false;
+  bool                                                  m_started    = false;
+  int                                                   m_k0         = 0;
+  int                                                   m_next       = 0;
+  int                                                   m_cycle      = -1;
+  int                                                   m_ihsym      = 0;
+  float                                                 m_sq         = 0.0f;
+  float                                                 m_peak       = 0.0f;
+  int                                                   m_count      = 0;
+};
+
+#endif
@@ -87,11 +87,37 @@ void highlightBlock(QTextBlock block, QFont font, QColor foreground, QColor back
   cursor.setCharFormat(charFormat);
 }
 
+// As highlightBlock(), but merging the character format rather than setting
+// it, so that the underlines drawn by the spell checker are kept, and only
+// what's changed since needs to be checked again.
+static void highlightTransmitBlock(QTextBlock block, QFont font, QColor foreground, QColor background){
+  QTextCursor cursor(block);
+
+  // Set background color
+  QTextBlockFormat blockFormat = cursor.blockFormat();
+  blockFormat.setBackground(background);
+  cursor.setBlockFormat(blockFormat);
+
+  // Set font, leaving underlines alone
+  cursor.select(QTextCursor::BlockUnderCursor);
+
+  auto charFormat = cursor.charFormat();
+  charFormat.setFont(font);
+  charFormat.setFontCapitalization(QFont::AllUppercase);
+  charFormat.setForeground(QBrush(foreground));
+  charFormat.clearProperty(QTextFormat::FontUnderline);
+  charFormat.clearProperty(QTextFormat::TextUnderlineStyle);
+  charFormat.clearProperty(QTextFormat::TextUnderlineColor);
+  cursor.mergeCharFormat(charFormat);
+}
+
 
 TransmitTextEdit::TransmitTextEdit(QWidget *parent):
     QTextEdit(parent),
     m_sent { 0 },
-    m_protected { false }
+    m_protected { false },
+    m_changedFrom { -1 },
+    m_changedTo { -1 }
 {
     connect(this, &QTextEdit::selectionChanged, this, &TransmitTextEdit::on_selectionChanged);
     connect(this, &QTextEdit::cursorPositionChanged, this, &TransmitTextEdit::on_selectionChanged);
@@ -195,6 +221,29 @@ void TransmitTextEdit::clear(){
     QTextEdit::clear();
 }
 
+QPair<int,int> TransmitTextEdit::takeChangedRange(){
+    QPair<int,int> range = { m_changedFrom, m_changedTo };
+    m_changedFrom = m_changedTo = -1;
+    return range;
+}
+
+// note that the text removed from pos and the text added there have changed,
+// moving along what had changed before past the change
+void TransmitTextEdit::noteChanged(int pos, int rem, int add){
+    if(m_changedFrom < 0){
+        m_changedFrom = pos;
+        m_changedTo = pos + add;
+        return;
+    }
+
+    if(m_changedTo >= pos + rem){
+        m_changedTo += add - rem;
+    }
+
+    m_changedFrom = qMin(m_changedFrom, pos);
+    m_changedTo = qMax(m_changedTo, pos + add);
+}
+
 void TransmitTextEdit::setProtected(bool protect){
     m_protected = protect;
 }
@@ -240,7 +289,7 @@ void TransmitTextEdit::on_selectionChanged(){
 }
 
 // slot
-void TransmitTextEdit::on_textContentsChanged(int /*pos*/, int rem, int add){
+void TransmitTextEdit::on_textContentsChanged(int pos, int rem, int add){
     if(rem == 0 && add == 0){
         return;
     }
@@ -250,6 +299,8 @@ void TransmitTextEdit::on_textContentsChanged(int /*pos*/, int rem, int add){
         return;
     }
 
+    noteChanged(pos, rem, add);
+
 #if JS8_ALLOW_EXTENDED
     QString normalized = text;
 #else
@@ -280,6 +331,8 @@ void TransmitTextEdit::on_textContentsChanged(int /*pos*/, int rem, int add){
             text = result;
         }
         blockSignals(blocked);
+
+        noteChanged(0, 0, text.size());
     }
 
     highlight();
@@ -296,7 +349,7 @@ void TransmitTextEdit::highlightBase(){
 
     auto block = d->firstBlock();
     while(block.isValid()){
-        highlightBlock(block, m_font, m_fg, m_bg);
+        highlightTransmitBlock(block, m_font, m_fg, m_bg);
         block = block.next();
     }
 }
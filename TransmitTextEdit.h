@@ -69,6 +69,9 @@ public:
         m_dirty = false;
     }
 
+    // the range of text changed since this was last called, or {-1, -1} if none has been
+    QPair<int,int> takeChangedRange();
+
     void highlightBase();
     void highlightCharsSent();
     void highlight();
@@ -80,11 +83,15 @@ public slots:
     void on_textContentsChanged(int pos, int rem, int add);
 
 private:
+    void noteChanged(int pos, int rem, int add);
+
     QString m_lastText;
     int m_sent;
     QString m_textSent;
     bool m_protected;
     bool m_dirty;
+    int m_changedFrom;
+    int m_changedTo;
     QFont m_font;
     QColor m_fg;
     QColor m_bg;
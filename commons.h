@@ -1,9 +1,9 @@
 #ifndef COMMONS_H
 #define COMMONS_H
 
+#include <atomic>
 #include <cstdbool>
 #include <cstdint>
-#include <mutex>
 
 // NSPS, the number of samples per second (at a sample rate of 1200
 // samples per second) is a constant, chosen so as to be a number
@@ -17,6 +17,7 @@
 
 #define JS8_RING_BUFFER    1       // use a ring buffer instead of clearing the decode frames
 #define JS8_DECODE_THREAD  1       // use a separate thread for decode process handling
+#define JS8_DECODE_PARALLEL 1      // decode sync candidates concurrently within a pass
 #define JS8_ALLOW_EXTENDED 1       // allow extended latin-1 capital charset
 #define JS8_AUTO_SYNC      1       // enable the experimental auto sync feature
 
@@ -53,7 +54,12 @@
 #define JS8I_TX_SECONDS     4
 #define JS8I_START_DELAY_MS 100
 
-extern struct dec_data
+// Everything shared between the components of a receiver, i.e., the
+// Detector that writes samples, the SpectrumEngine that analyzes them
+// for display, and the Decoder that decodes them. There's one of these
+// per receiver; nothing here is global.
+
+struct dec_data
 {
   std::int16_t d2[JS8_RX_SAMPLE_SIZE]; // sample frame buffer for sample collection
   struct
@@ -64,6 +70,10 @@ extern struct dec_data
     int nfa;                    // Low decode limit (Hz) (filter min)
     int nfb;                    // High decode limit (Hz) (filter max)
     bool syncStats;              // only compute sync candidates
+    bool minsum;                // use the min-sum LDPC decoder
+    bool early;                 // defer candidates until their frames are complete
+    bool stats;                 // emit decoder statistics
+    bool syncOnly;              // stop after the first sync search, for benchmarking
     int kin;                    // number of frames written to d2
     int kposA;                  // starting position of decode for submode A
     int kposB;                  // starting position of decode for submode B
@@ -77,17 +87,38 @@ extern struct dec_data
     int kszI;                   // number of frames for decode for submode I
     int nsubmodes;              // which submodes to decode
   } params;
-} dec_data;
+  std::atomic<std::uint32_t> epoch; // odd while d2 is being modified other than by appending at kin
+};
+
+// The decoder reads samples from d2 in place, without holding the
+// Detector mutex; anything that modifies samples in d2, other than
+// appending them at kin, must do so under the Detector mutex while
+// holding one of these, which allows the decoder to determine that
+// what it read might not have been stable. Restarting kin at the top
+// of the buffer counts as a modification, since appending afterward
+// overwrites samples the decoder might have retained results from.
 
-extern struct
-specData
+struct dec_data_epoch_guard
 {
-  float savg[JS8_NSMAX];
-  float slin[JS8_NSMAX];
-}
-specData;
+  explicit dec_data_epoch_guard(struct dec_data & data)
+    : m_epoch(data.epoch)
+  {
+    m_epoch.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
-extern std::mutex fftw_mutex;
+  ~dec_data_epoch_guard()
+  {
+    m_epoch.fetch_add(1, std::memory_order_release);
+  }
+
+  dec_data_epoch_guard(dec_data_epoch_guard const &) = delete;
+  dec_data_epoch_guard & operator=(dec_data_epoch_guard const &) = delete;
+
+private:
+
+  std::atomic<std::uint32_t> & m_epoch;
+};
 
 // The way we squeeze a timestamp into an int.
 // See also decode_time() below.
@@ -0,0 +1,1331 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <locale.h>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QThreadPool>
+#include <QMap>
+#include <QStringList>
+#include <QVector>
+#include "commons.h"
+#include "decodedtext.h"
+#include "FFTW.hpp"
+#include "JS8.hpp"
+#include "JS8Submode.hpp"
+#include "jsc.h"
+#include "varicode.h"
+
+// Development benchmarks; not installed. Benchmarks the decoder against
+// synthesized signals, reporting timings and decode yield versus SNR as
+// JSON, such that the results of different builds, or of different
+// decoder options, can be compared directly; see the Benchmark section
+// below. Alternatively, benchmarks message packing and unpacking; see
+// the Codec Benchmark section below.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  // Submodes we know how to decode, along with the letter used to select
+  // each of them on the command line.
+
+  struct Submode
+  {
+    char letter;
+    int  submode;
+    bool enabled;
+  };
+
+  constexpr std::array SUBMODES
+  {
+    Submode{'A', Varicode::JS8CallNormal, JS8_ENABLE_JS8A},
+    Submode{'B', Varicode::JS8CallFast,   JS8_ENABLE_JS8B},
+    Submode{'C', Varicode::JS8CallTurbo,  JS8_ENABLE_JS8C},
+    Submode{'E', Varicode::JS8CallSlow,   JS8_ENABLE_JS8E},
+    Submode{'I', Varicode::JS8CallUltra,  JS8_ENABLE_JS8I}
+  };
+
+  // Bit used for the submode in the decoder's nsubmodes bitset; normal
+  // mode's identifier is zero, so it's special.
+
+  constexpr int
+  submodeBit(int const submode)
+  {
+    return submode ? submode << 1 : 1;
+  }
+
+  // Decoder options that apply to every scene.
+
+  struct Options
+  {
+    std::vector<int> submodes;
+    int              nfqso  = 1500;
+    int              nfa    = 0;
+    int              nfb    = 5000;
+    bool             minsum = false;
+  };
+
+  // Run a task for each index in [0, count), concurrently, across jobs that
+  // each own a decoder; each job takes the next index until there are none
+  // left. Results are handed to the consumer on the calling thread, in index
+  // order, as they become available, in the same manner as the decoder
+  // releases events in dispatch order.
+
+  template <typename Produce,
+            typename Consume>
+  void
+  dispatch(int       const jobs,
+           qsizetype const count,
+           Produce         produce,
+           Consume         consume)
+  {
+    using Result = std::invoke_result_t<Produce, JS8::OfflineDecoder &, qsizetype>;
+
+    std::vector<std::optional<Result>> results(count);
+    std::atomic<qsizetype>             next = 0;
+    std::mutex                         mutex;
+    std::condition_variable            condition;
+    QThreadPool                        pool;
+
+    pool.setMaxThreadCount(std::clamp(jobs, 1, static_cast<int>(std::max(count, qsizetype(1)))));
+
+    for (int job = 0; job < pool.maxThreadCount(); ++job)
+    {
+      pool.start([&]()
+      {
+        JS8::OfflineDecoder decoder;
+
+        for (auto index = next++; index < count; index = next++)
+        {
+          auto result = produce(decoder, index);
+
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            results[index] = std::move(result);
+          }
+
+          condition.notify_one();
+        }
+      });
+    }
+
+    for (auto & result : results)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      condition.wait(lock, [&result] { return result.has_value(); });
+
+      auto value = std::move(*result);
+
+      lock.unlock();
+      consume(value);
+    }
+
+    pool.waitForDone();
+  }
+}
+
+/******************************************************************************/
+// Benchmark
+/******************************************************************************/
+
+namespace
+{
+  // The benchmark synthesizes reproducible band scenes, decodes them, and
+  // reports timings and decode yield versus SNR, as JSON. Each scene is a
+  // single period of a single submode, containing a number of signals at
+  // random frequencies and with random DT, some of them colliding with one
+  // another, in Gaussian noise, all signals at the same SNR. Optionally,
+  // only the sync search is run, and only its timings are reported, or the
+  // scenes are decoded with each of the LDPC decoders, and the results of
+  // each are reported.
+
+  struct Benchmark
+  {
+    std::uint32_t seed        = 1;
+    int           signalCount = 10;
+    int           scenes      = 2;
+    bool          syncOnly    = false;
+    bool          compareBP   = false;
+    QString       golden;
+  };
+
+  // Scenes cover SNRs from below the submode's threshold to well above it;
+  // signals lie within this range of audio frequencies, and are jittered in
+  // DT by up to this much, relative to their nominal start.
+
+  constexpr int    SNR_BELOW  = 6;
+  constexpr int    SNR_ABOVE  = 6;
+  constexpr int    SNR_STEP   = 2;
+  constexpr double FREQ_MIN   = 500.0;
+  constexpr double FREQ_MAX   = 2500.0;
+  constexpr double DT_JITTER  = 0.5;
+  constexpr double NOISE      = 100.0;   // Standard deviation of the noise
+  constexpr double TAU        = 2 * M_PI;
+
+  constexpr std::string_view ALPHABET = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-+";
+
+  // Deterministic source of random numbers; the standard distributions are
+  // not specified exactly, so we derive our own from the engine's output,
+  // which is, such that scenes are the same on every platform.
+
+  class Random
+  {
+    std::mt19937 m_engine;
+
+  public:
+
+    explicit Random(std::initializer_list<std::uint32_t> const seeds)
+    {
+      std::seed_seq seq(seeds);
+      m_engine.seed(seq);
+    }
+
+    // Uniform in [0, 1), [a, b), and [0, n) respectively.
+
+    double uniform()                     { return (m_engine() >> 8) * 0x1.0p-24; }
+    double uniform(double a, double b)   { return a + (b - a) * uniform();        }
+    int    index(std::size_t const n)    { return static_cast<int>(uniform() * n); }
+
+    // Standard normal, via the Box-Muller transform.
+
+    double
+    gaussian()
+    {
+      auto const u1 = 1.0 - uniform();
+      auto const u2 = uniform();
+
+      return std::sqrt(-2.0 * std::log(u1)) * std::cos(TAU * u2);
+    }
+  };
+
+  struct Scene
+  {
+    int submode;
+    int snr;
+    int index;
+  };
+
+  struct Point
+  {
+    int                      injected  = 0;
+    int                      decoded   = 0;
+    int                      spurious  = 0;
+    int                      codewords = 0;  // Presented to the LDPC decoder
+    std::chrono::nanoseconds wall      = {};
+    JS8::Timings             timings;
+
+    Point &
+    operator+=(Point const & other)
+    {
+      injected  += other.injected;
+      decoded   += other.decoded;
+      spurious  += other.spurious;
+      codewords += other.codewords;
+      wall      += other.wall;
+
+      timings  += other.timings;
+
+      return *this;
+    }
+  };
+
+  // Synthesize a scene and decode it. Signals are generated in the same
+  // manner as the Modulator does, i.e., continuous-phase FSK of the tones
+  // produced by the encoder, but at 12kHz rather than at 48kHz. Every fourth
+  // signal is placed so as to overlap in frequency one placed before it.
+
+  Point
+  runScene(JS8::OfflineDecoder       & decoder,
+           Options             const & options,
+           Benchmark           const & benchmark,
+           Scene               const & scene)
+  {
+    Random random({benchmark.seed,
+                   static_cast<std::uint32_t>(scene.submode),
+                   static_cast<std::uint32_t>(scene.snr),
+                   static_cast<std::uint32_t>(scene.index)});
+
+    int    const   cycle     = JS8::Submode::framesPerCycle(scene.submode);
+    int    const   nsps      = JS8::Submode::symbolSamples(scene.submode);
+    double const   spacing   = JS8::Submode::toneSpacing(scene.submode);
+    double const   bandwidth = JS8::Submode::bandwidth(scene.submode);
+    double const   delay     = JS8::Submode::startDelayMS(scene.submode) / 1000.0;
+    auto   const & costas    = JS8::Costas::array(JS8::Submode::costas(scene.submode));
+
+    // Signal amplitude yielding the requested SNR in a 2500Hz bandwidth,
+    // given noise spread evenly across the 6000Hz Nyquist bandwidth.
+
+    double const amplitude = NOISE * std::sqrt(2.0 * std::pow(10.0, scene.snr / 10.0) * 2500.0 / 6000.0);
+
+    std::vector<double>                   wave(cycle);
+    std::vector<double>                   frequencies;
+    std::set<std::pair<std::string, int>> injected;
+
+    for (auto & sample : wave) sample = NOISE * random.gaussian();
+
+    for (int i = 0; i < benchmark.signalCount; ++i)
+    {
+      std::string                      message(12, ' ');
+      std::array<int, JS8_NUM_SYMBOLS> tones;
+
+      for (auto & c : message) c = ALPHABET[random.index(ALPHABET.size())];
+
+      auto const type = random.index(8);
+
+      JS8::encode(type, costas, message.c_str(), tones.data());
+
+      auto const frequency = (i % 4 == 3)
+                           ? std::clamp(frequencies[random.index(frequencies.size())] + random.uniform(-0.5, 0.5) * bandwidth,
+                                        FREQ_MIN,
+                                        FREQ_MAX - bandwidth)
+                           : random.uniform(FREQ_MIN, FREQ_MAX - bandwidth);
+      auto const dt        = random.uniform(-std::min(delay, DT_JITTER), DT_JITTER);
+      auto const start     = static_cast<int>(std::round((delay + dt) * JS8_RX_SAMPLE_RATE));
+      auto       phi       = random.uniform(0.0, TAU);
+
+      for (int j = 0; j < JS8_NUM_SYMBOLS * nsps && start + j < cycle; ++j)
+      {
+        phi += TAU * (frequency + tones[j / nsps] * spacing) / JS8_RX_SAMPLE_RATE;
+
+        if (phi > TAU) phi -= TAU;
+
+        wave[start + j] += amplitude * std::sin(phi);
+      }
+
+      frequencies.push_back(frequency);
+      injected.emplace(message, type);
+    }
+
+    std::vector<std::int16_t> samples(cycle);
+
+    std::transform(wave.begin(), wave.end(), samples.begin(), [](double const value)
+    {
+      return static_cast<std::int16_t>(std::clamp(std::round(value), -32768.0, 32767.0));
+    });
+
+    // Decode the scene, and score the result.
+
+    Point                                 point;
+    std::set<std::pair<std::string, int>> decoded;
+    auto const                            start = std::chrono::steady_clock::now();
+
+    decoder.decode(samples.data(),
+                   cycle,
+                   {
+                     .nsubmodes = submodeBit(scene.submode),
+                     .nfqso     = options.nfqso,
+                     .nfa       = options.nfa,
+                     .nfb       = options.nfb,
+                     .minsum    = options.minsum,
+                     .syncOnly  = benchmark.syncOnly,
+                     .stats     = true
+                   },
+                   [&decoded, &point](JS8::Event::Variant const & event)
+                   {
+                     if (auto const d = std::get_if<JS8::Event::Decoded>(&event))
+                     {
+                       decoded.emplace(d->data, d->type);
+                     }
+                     else if (auto const s = std::get_if<JS8::Event::Stats>(&event))
+                     {
+                       point.codewords += s->bpCodewords;
+                     }
+                   },
+                   &point.timings);
+
+    point.wall     = std::chrono::steady_clock::now() - start;
+    point.injected = static_cast<int>(injected.size());
+
+    for (auto const & entry : decoded)
+    {
+      ++(injected.contains(entry) ? point.decoded : point.spurious);
+    }
+
+    return point;
+  }
+
+  // Conversion of durations to JSON, as milliseconds.
+
+  QJsonValue
+  milliseconds(std::chrono::nanoseconds const duration)
+  {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  }
+
+  QJsonObject
+  toJson(int   const   snr,
+         Point const & point)
+  {
+    QJsonArray passes;
+
+    for (auto const pass : point.timings.passes) passes.append(milliseconds(pass));
+
+    auto const reported = point.decoded + point.spurious;
+
+    return
+    {
+      {"snr",        snr},
+      {"injected",   point.injected},
+      {"decoded",    point.decoded},
+      {"spurious",   point.spurious},
+      {"yield",      point.injected ? double(point.decoded) / point.injected : 0.0},
+      {"false_rate", reported ? double(point.spurious) / reported : 0.0},
+      {"codewords",  point.codewords},
+      {"bp_ns",      point.codewords ? double(point.timings.bpdecode.count()) / point.codewords : 0.0},
+      {"wall_ms",    milliseconds(point.wall)},
+      {"passes_ms",  passes},
+      {"stages_ms", QJsonObject
+        {
+          {"sync",       milliseconds(point.timings.sync)},
+          {"candidates", milliseconds(point.timings.candidates)},
+          {"downsample", milliseconds(point.timings.downsample)},
+          {"bpdecode",   milliseconds(point.timings.bpdecode)},
+          {"subtract",   milliseconds(point.timings.subtract)}
+        }
+      }
+    };
+  }
+
+  // Run the scenes for each submode and SNR, returning the results summed
+  // by submode and SNR.
+
+  std::map<std::pair<int, int>, Point>
+  runScenes(int       const   jobs,
+            Options   const & options,
+            Benchmark const & benchmark)
+  {
+    std::vector<Scene> scenes;
+
+    for (auto const submode : options.submodes)
+    {
+      auto const threshold = JS8::Submode::rxSNRThreshold(submode);
+
+      for (int snr = threshold - SNR_BELOW; snr <= threshold + SNR_ABOVE; snr += SNR_STEP)
+      {
+        for (int index = 0; index < benchmark.scenes; ++index) scenes.push_back({submode, snr, index});
+      }
+    }
+
+    std::map<std::pair<int, int>, Point> points;
+
+    dispatch(jobs,
+             static_cast<qsizetype>(scenes.size()),
+             [&](JS8::OfflineDecoder & decoder,
+                 qsizetype     const   index)
+             {
+               return runScene(decoder, options, benchmark, scenes[index]);
+             },
+             [&, index = std::size_t(0)](Point const & point) mutable
+             {
+               auto const & scene = scenes[index++];
+               points[{scene.submode, scene.snr}] += point;
+             });
+
+    return points;
+  }
+
+  // Run the sync benchmark, writing the report to standard output. Scenes
+  // are as for the full benchmark, but only the first sync search of each
+  // is run, i.e., the computation of the symbol spectra, the sync search,
+  // and the selection of candidates; reported are the mean times, per
+  // scene, of the whole, and of the candidate selection part of it.
+
+  int
+  runSyncBenchmark(int       const   jobs,
+                   Options   const & options,
+                   Benchmark const & benchmark)
+  {
+    auto const points = runScenes(jobs, options, benchmark);
+
+    QJsonObject submodes;
+
+    for (auto const submode : options.submodes)
+    {
+      Point total;
+      int   count = 0;
+
+      for (auto const & [key, point] : points)
+      {
+        if (key.first != submode) continue;
+
+        total += point;
+        count += benchmark.scenes;
+      }
+
+      auto const mean = [count](std::chrono::nanoseconds const duration)
+      {
+        return milliseconds(duration / std::max(count, 1));
+      };
+
+      submodes[JS8::Submode::name(submode)] = QJsonObject
+      {
+        {"scenes",        count},
+        {"sync_ms",       mean(total.timings.sync)},
+        {"candidates_ms", mean(total.timings.candidates)}
+      };
+    }
+
+    QJsonObject report
+    {
+      {"seed",     static_cast<qint64>(benchmark.seed)},
+      {"signals",  benchmark.signalCount},
+      {"scenes",   benchmark.scenes},
+      {"syncOnly", true},
+      {"submodes", submodes}
+    };
+
+    std::cout << QJsonDocument(report).toJson(QJsonDocument::Indented).constData() << std::flush;
+
+    return 0;
+  }
+
+  // Summarize the results for each submode, by SNR and in total; SNR points
+  // that decoded fewer signals than they did in the golden results for the
+  // submode, if any, are appended to the regressions, attributed to the
+  // algorithm, if there is one.
+
+  QJsonObject
+  summarize(Options                              const & options,
+            std::map<std::pair<int, int>, Point> const & points,
+            QJsonObject                          const & golden,
+            QString                              const & algorithm,
+            QJsonArray                                 & regressions)
+  {
+    QJsonObject submodes;
+
+    for (auto const submode : options.submodes)
+    {
+      auto const name = JS8::Submode::name(submode);
+      auto const gold = golden.value(name).toObject().value("points").toArray();
+
+      QJsonArray array;
+      Point      total;
+
+      for (auto const & [key, point] : points)
+      {
+        if (key.first != submode) continue;
+
+        array.append(toJson(key.second, point));
+        total += point;
+
+        for (auto const & value : gold)
+        {
+          if (auto const object = value.toObject();
+                         object["snr"].toInt()     == key.second &&
+                         object["decoded"].toInt() >  point.decoded)
+          {
+            QJsonObject regression
+            {
+              {"submode", name},
+              {"snr",     key.second},
+              {"decoded", point.decoded},
+              {"golden",  object["decoded"].toInt()}
+            };
+
+            if (!algorithm.isEmpty()) regression["algorithm"] = algorithm;
+
+            regressions.append(regression);
+          }
+        }
+      }
+
+      auto summary = toJson(0, total);
+
+      summary.remove("snr");
+      summary["points"] = array;
+      submodes[name]    = summary;
+    }
+
+    return submodes;
+  }
+
+  // Run the benchmark, writing the report to standard output; returns the
+  // exit status, which is non-zero if any SNR point of any submode decoded
+  // fewer signals than it did in the golden report, if one was provided.
+  // When comparing LDPC decoders, the scenes are decoded once with each of
+  // them, and the report, as well as the golden report, has the results of
+  // each under its name.
+
+  int
+  runBenchmark(int       const   jobs,
+               Options   const & options,
+               Benchmark const & benchmark)
+  {
+    QJsonObject golden;
+
+    if (!benchmark.golden.isEmpty())
+    {
+      QFile file(benchmark.golden);
+
+      if (!file.open(QIODevice::ReadOnly))
+      {
+        std::cerr << benchmark.golden.toLocal8Bit().constData() << ": " << file.errorString().toLocal8Bit().constData() << std::endl;
+        return 1;
+      }
+
+      golden = QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    QJsonObject report
+    {
+      {"seed",    static_cast<qint64>(benchmark.seed)},
+      {"signals", benchmark.signalCount},
+      {"scenes",  benchmark.scenes}
+    };
+
+    QJsonArray regressions;
+
+    if (benchmark.compareBP)
+    {
+      QJsonObject algorithms;
+
+      for (auto const minsum : {false, true})
+      {
+        auto const name     = QString(minsum ? "minSum" : "sumProduct");
+        auto       compared = options;
+
+        compared.minsum = minsum;
+
+        algorithms[name] = QJsonObject
+        {
+          {"submodes", summarize(compared,
+                                 runScenes(jobs, compared, benchmark),
+                                 golden.value("algorithms").toObject().value(name).toObject().value("submodes").toObject(),
+                                 name,
+                                 regressions)}
+        };
+      }
+
+      report["algorithms"] = algorithms;
+    }
+    else
+    {
+      report["minsum"]   = options.minsum;
+      report["submodes"] = summarize(options,
+                                     runScenes(jobs, options, benchmark),
+                                     golden.value("submodes").toObject(),
+                                     QString(),
+                                     regressions);
+    }
+
+    if (!benchmark.golden.isEmpty()) report["regressions"] = regressions;
+
+    std::cout << QJsonDocument(report).toJson(QJsonDocument::Indented).constData() << std::flush;
+
+    return regressions.isEmpty() ? 0 : 2;
+  }
+}
+
+/******************************************************************************/
+// Codec Benchmark
+/******************************************************************************/
+
+namespace
+{
+  // The codec benchmark measures the throughput of message packing and
+  // unpacking, i.e., of building the frames for a set of representative
+  // messages, as is done for transmission, and of unpacking each of the
+  // frames built, as is done for each decode, reporting it as JSON. It's
+  // purely computational, so reports from different builds are directly
+  // comparable; the digest of the unpacked text should be the same.
+  //
+  // Data frames are in addition packed and unpacked by the bit vector
+  // implementation that BitStream replaced, retained below, such that a
+  // single run reports both, and whether they agree.
+
+  constexpr std::array MESSAGES
+  {
+    "HELLO WORLD",
+    "CQ CQ CQ",
+    "J1Y: SNR?",
+    "J1Y: HEARING?",
+    "J1Y: SNR -10",
+    "J1Y: GRID EM73TU",
+    "@ALLCALL QUERY MSGS",
+    "J1Y: THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789",
+    "J1Y: MSG TO:K1ABC PLEASE PASS ALONG THAT THE NET STARTS AT 1900Z ON 7078",
+    "GOOD MORNING, I'M RUNNING 5W INTO A DIPOLE, AND YOUR SIGNAL IS FB HERE. 73!"
+  };
+
+  // The data frame codec as it was when bits were held in QVector<bool>;
+  // it's here only for comparison, and is otherwise as it was, naive
+  // Huffman decoding included.
+
+  namespace Legacy
+  {
+    using Bits = QVector<bool>;
+
+    QChar const EOT = '\x04';
+
+    Bits
+    intToBits(quint64 value,
+              int     expected)
+    {
+      Bits bits;
+
+      while (value)
+      {
+        bits.prepend(static_cast<bool>(value & 1));
+        value = value >> 1;
+      }
+
+      while (bits.count() < expected) bits.prepend(false);
+
+      return bits;
+    }
+
+    quint64
+    bitsToInt(Bits::ConstIterator start,
+              int                 n)
+    {
+      quint64 v = 0;
+
+      for (int i = 0; i < n; ++i, ++start) v = (v << 1) + static_cast<int>(*start);
+
+      return v;
+    }
+
+    quint64
+    bitsToInt(Bits const & bits)
+    {
+      return bitsToInt(bits.constBegin(), bits.count());
+    }
+
+    Bits
+    strToBits(QString const & str)
+    {
+      Bits bits;
+
+      for (auto const ch : str) bits.append(ch == '1');
+
+      return bits;
+    }
+
+    QString
+    bitsToStr(Bits const & bits)
+    {
+      QString str;
+
+      for (auto const bit : bits) str.append(bit ? "1" : "0");
+
+      return str;
+    }
+
+    QList<QPair<int, Bits>>
+    huffEncode(QMap<QString, QString> const & huff,
+               QString                const & text)
+    {
+      QList<QPair<int, Bits>> out;
+
+      auto keys = huff.keys();
+
+      std::sort(keys.begin(), keys.end(), [](QString const & a,
+                                             QString const & b)
+      {
+        if (b.length() < a.length()) return true;
+        if (a.length() < b.length()) return false;
+        return b < a;
+      });
+
+      for (int i = 0; i < text.length();)
+      {
+        bool found = false;
+
+        for (auto const & ch : keys)
+        {
+          if (QStringView(text.begin() + i, text.end()).startsWith(ch))
+          {
+            out.append({ch.length(), strToBits(huff[ch])});
+            i    += ch.length();
+            found = true;
+            break;
+          }
+        }
+
+        if (!found) ++i;
+      }
+
+      return out;
+    }
+
+    QString
+    huffDecode(QMap<QString, QString> const & huff,
+               Bits                   const & bitvec)
+    {
+      QString text;
+      QString bits = bitsToStr(bitvec);
+
+      while (bits.length() > 0)
+      {
+        bool found = false;
+
+        for (auto const & key : huff.keys())
+        {
+          if (bits.startsWith(huff[key]))
+          {
+            if (key == EOT)
+            {
+              text.append(" ");
+              found = false;
+              break;
+            }
+            text.append(key);
+            bits  = bits.mid(huff[key].length());
+            found = true;
+          }
+        }
+
+        if (!found) break;
+      }
+
+      return text;
+    }
+
+    Bits
+    codeword(quint32 const index,
+             bool    const separate,
+             quint32 const bytesize,
+             quint32 const s,
+             quint32 const c)
+    {
+      QList<Bits> out;
+
+      out.prepend(intToBits(((index % s) << 1) + static_cast<quint32>(separate), bytesize + 1));
+
+      for (quint32 x = index / s; x > 0; x /= c)
+      {
+        x -= 1;
+        out.prepend(intToBits((x % c) + s, bytesize));
+      }
+
+      Bits word;
+
+      for (auto const & w : out) word.append(w);
+
+      return word;
+    }
+
+    QList<QPair<Bits, quint32>>
+    compress(QString const & text)
+    {
+      QList<QPair<Bits, quint32>> out;
+
+      quint32 const b = 4;
+      quint32 const s = 7;
+      quint32 const c = std::pow(2, 4) - s;
+
+      auto const words = text.split(" ", Qt::KeepEmptyParts);
+
+      for (int i = 0, len = words.length(); i < len; ++i)
+      {
+        auto       w                = words[i];
+        bool const isLastWord       = (i == len - 1);
+        bool       isSpaceCharacter = false;
+
+        // If this is an empty part, it should be a space, unless it's the
+        // last word.
+
+        if (w.isEmpty() && !isLastWord)
+        {
+          w                = " ";
+          isSpaceCharacter = true;
+        }
+
+        while (!w.isEmpty())
+        {
+          bool       ok    = false;
+          auto const index = JSC::lookup(w, &ok);
+
+          if (!ok) break;
+
+          auto const size = JSC::map[index].size;
+
+          w = w.mid(size);
+
+          bool const shouldAppendSpace = w.isEmpty() && !isSpaceCharacter && !isLastWord;
+
+          out.append({codeword(index, shouldAppendSpace, b, s, c),
+                      static_cast<quint32>(size) + (shouldAppendSpace ? 1 : 0)});
+        }
+      }
+
+      return out;
+    }
+
+    QString
+    decompress(Bits const & bitvec)
+    {
+      quint32 const s = 7;
+      quint32 const c = std::pow(2, 4) - s;
+
+      quint32 base[8];
+      base[0] = 0;
+      base[1] = s;
+      base[2] = base[1] + s*c;
+      base[3] = base[2] + s*c*c;
+      base[4] = base[3] + s*c*c*c;
+      base[5] = base[4] + s*c*c*c*c;
+      base[6] = base[5] + s*c*c*c*c*c;
+      base[7] = base[6] + s*c*c*c*c*c*c;
+
+      QStringList    out;
+      QList<quint64> bytes;
+      QList<quint32> separators;
+
+      for (int i = 0, count = bitvec.count(); i < count;)
+      {
+        auto const b = bitvec.mid(i, 4);
+
+        if (b.length() != 4) break;
+
+        quint64 const byte = bitsToInt(b);
+
+        bytes.append(byte);
+        i += 4;
+
+        if (byte < s)
+        {
+          if (count - i > 0 && bitvec.at(i)) separators.append(bytes.length() - 1);
+          i += 1;
+        }
+      }
+
+      for (quint32 start = 0; start < static_cast<quint32>(bytes.length());)
+      {
+        quint32 k = 0;
+        quint32 j = 0;
+
+        while (start + k < static_cast<quint32>(bytes.length()) && bytes[start + k] >= s)
+        {
+          j = j*c + (bytes[start + k] - s);
+          k++;
+        }
+
+        if (j >= JSC::size) break;
+        if (start + k >= static_cast<quint32>(bytes.length())) break;
+
+        j = j*s + bytes[start + k] + base[k];
+
+        if (j >= JSC::size) break;
+
+        out.append(QLatin1String(JSC::map[j].str));
+
+        if (!separators.isEmpty() && separators.first() == start + k)
+        {
+          out.append(" ");
+          separators.removeFirst();
+        }
+
+        start = start + (k + 1);
+      }
+
+      return out.join("");
+    }
+
+    // Pad the frame bits to 72, setting the first pad bit to 0 and the rest
+    // to 1, and pack them.
+
+    QString
+    packFrame(Bits frameBits)
+    {
+      for (int i = 0, pad = 72 - frameBits.length(); i < pad; ++i) frameBits.append(i != 0);
+
+      return Varicode::pack72bits(bitsToInt(frameBits.constBegin(), 64),
+                                  bitsToInt(frameBits.constBegin() + 64, 8));
+    }
+
+    QString
+    packHuffMessage(QString const & input,
+                    Bits    const & prefix,
+                    int           * n)
+    {
+      auto const validChars = Varicode::huffValidChars(Varicode::defaultHuffTable());
+
+      for (auto const ch : input)
+      {
+        if (!validChars.contains(ch.toUpper()))
+        {
+          *n = 0;
+          return QString();
+        }
+      }
+
+      Bits frameBits = prefix;
+      int  i         = 0;
+
+      for (auto const & [charN, charBits] : huffEncode(Varicode::defaultHuffTable(), input))
+      {
+        if (frameBits.length() + charBits.length() >= 72) break;
+        frameBits += charBits;
+        i         += charN;
+      }
+
+      *n = i;
+
+      return packFrame(frameBits);
+    }
+
+    QString
+    packCompressedMessage(QString const & input,
+                          Bits    const & prefix,
+                          int           * n)
+    {
+      Bits frameBits = prefix;
+      int  i         = 0;
+
+      for (auto const & [bits, chars] : compress(input))
+      {
+        if (frameBits.length() + bits.length() >= 72) break;
+        frameBits.append(bits);
+        i += chars;
+      }
+
+      *n = i;
+
+      return packFrame(frameBits);
+    }
+
+    QString
+    packDataMessage(QString const & input,
+                    int           * n)
+    {
+      int        huffChars       = 0;
+      int        compressedChars = 0;
+      auto const huffFrame       = packHuffMessage(input, {true, false}, &huffChars);
+      auto const compressedFrame = packCompressedMessage(input, {true, true}, &compressedChars);
+
+      *n = std::max(huffChars, compressedChars);
+
+      return huffChars > compressedChars ? huffFrame : compressedFrame;
+    }
+
+    QString
+    unpackDataMessage(QString const & text)
+    {
+      if (text.length() < 12 || text.contains(" ")) return QString();
+
+      quint8     rem   = 0;
+      auto const value = Varicode::unpack72bits(text, &rem);
+      auto       bits  = intToBits(value, 64) + intToBits(rem, 8);
+
+      if (!bits.at(0)) return QString();
+
+      bits = bits.mid(1);
+
+      bool const compressed = bits.at(0);
+      int  const n          = bits.lastIndexOf(0);
+
+      bits = bits.mid(1, n - 1);
+
+      return compressed ? decompress(bits)
+                        : huffDecode(Varicode::defaultHuffTable(), bits);
+    }
+
+    QString
+    packFastDataMessage(QString const & input,
+                        int           * n)
+    {
+      return packCompressedMessage(input, {}, n);
+    }
+
+    QString
+    unpackFastDataMessage(QString const & text)
+    {
+      if (text.length() < 12 || text.contains(" ")) return QString();
+
+      quint8     rem   = 0;
+      auto const value = Varicode::unpack72bits(text, &rem);
+      auto const bits  = intToBits(value, 64) + intToBits(rem, 8);
+
+      return decompress(bits.mid(0, bits.lastIndexOf(0)));
+    }
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  QJsonValue
+  microseconds(Clock::duration const duration,
+               qsizetype       const count)
+  {
+    return std::chrono::duration<double, std::micro>(duration).count() / std::max<qsizetype>(count, 1);
+  }
+
+  // Results of packing each of the messages into data frames, as many as
+  // it takes, and of unpacking each of the frames.
+
+  struct DataRun
+  {
+    QStringList     frames;
+    QString         text;
+    Clock::duration pack   = {};
+    Clock::duration unpack = {};
+
+    QJsonObject
+    toJson(int const iterations) const
+    {
+      return QJsonObject
+      {
+        {"pack_us_per_msg",     microseconds(pack,   iterations * static_cast<qsizetype>(MESSAGES.size()))},
+        {"unpack_us_per_frame", microseconds(unpack, iterations * frames.size())},
+        {"digest",              QString::number(qHash(text), 16)}
+      };
+    }
+  };
+
+  template <typename Pack,
+            typename Unpack>
+  DataRun
+  runDataFrames(int    const iterations,
+                Pack         pack,
+                Unpack       unpack)
+  {
+    DataRun run;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+      run.frames.clear();
+      run.text.clear();
+
+      auto const start = Clock::now();
+
+      for (auto const message : MESSAGES)
+      {
+        for (QString input = message; !input.isEmpty();)
+        {
+          int n = 0;
+          auto const frame = pack(input, &n);
+
+          if (n <= 0) break;
+
+          run.frames.append(frame);
+          input = input.mid(n);
+        }
+      }
+
+      auto const middle = Clock::now();
+
+      for (auto const & frame : run.frames) run.text += unpack(frame);
+
+      auto const end = Clock::now();
+
+      run.pack   += middle - start;
+      run.unpack += end    - middle;
+    }
+
+    return run;
+  }
+
+  template <typename Pack,
+            typename Unpack,
+            typename LegacyPack,
+            typename LegacyUnpack>
+  QJsonObject
+  compareDataFrames(int          const iterations,
+                    Pack               pack,
+                    Unpack             unpack,
+                    LegacyPack         legacyPack,
+                    LegacyUnpack       legacyUnpack,
+                    bool             & identical)
+  {
+    auto const current = runDataFrames(iterations, pack,       unpack);
+    auto const legacy  = runDataFrames(iterations, legacyPack, legacyUnpack);
+    auto const same    = current.frames == legacy.frames && current.text == legacy.text;
+
+    identical = identical && same;
+
+    return QJsonObject
+    {
+      {"frames",    static_cast<qint64>(current.frames.size())},
+      {"current",   current.toJson(iterations)},
+      {"legacy",    legacy.toJson(iterations)},
+      {"identical", same}
+    };
+  }
+
+  // Run the codec benchmark; exits with status 2 if the current and the
+  // legacy data frame codecs disagree.
+
+  int
+  runCodecBenchmark(int const iterations)
+  {
+    QList<QPair<QString, int>> frames;
+    Clock::duration            build  = {};
+    Clock::duration            unpack = {};
+    QString                    text;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+      frames.clear();
+      text.clear();
+
+      auto const start = Clock::now();
+
+      for (auto const message : MESSAGES)
+      {
+        frames += Varicode::buildMessageFrames("KN4CRD",
+                                               "EM73",
+                                               "J1Y",
+                                               message,
+                                               false,
+                                               false,
+                                               Varicode::JS8CallNormal);
+      }
+
+      auto const middle = Clock::now();
+
+      for (auto const & [frame, bits] : frames)
+      {
+        text += DecodedText(frame, bits, Varicode::JS8CallNormal).message();
+      }
+
+      auto const end = Clock::now();
+
+      build  += middle - start;
+      unpack += end    - middle;
+    }
+
+    bool identical = true;
+
+    QJsonObject report
+    {
+      {"iterations",          iterations},
+      {"messages",            static_cast<qint64>(MESSAGES.size())},
+      {"frames",              static_cast<qint64>(frames.size())},
+      {"build_us_per_msg",    microseconds(build,  iterations * static_cast<qsizetype>(MESSAGES.size()))},
+      {"unpack_us_per_frame", microseconds(unpack, iterations * frames.size())},
+      {"digest",              QString::number(qHash(text), 16)},
+      {"data_frames",         compareDataFrames(iterations,
+                                                Varicode::packDataMessage,
+                                                Varicode::unpackDataMessage,
+                                                Legacy::packDataMessage,
+                                                Legacy::unpackDataMessage,
+                                                identical)},
+      {"fast_data_frames",    compareDataFrames(iterations,
+                                                Varicode::packFastDataMessage,
+                                                Varicode::unpackFastDataMessage,
+                                                Legacy::packFastDataMessage,
+                                                Legacy::unpackFastDataMessage,
+                                                identical)}
+    };
+
+    std::cout << QJsonDocument(report).toJson(QJsonDocument::Indented).constData() << std::flush;
+
+    return identical ? 0 : 2;
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main(int    argc,
+     char * argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  setlocale(LC_NUMERIC, "C");
+
+  app.setApplicationName("js8bench");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Benchmarks the JS8 decoder against synthesized signals, reporting timings and yield versus SNR as JSON.");
+  parser.addHelpOption();
+
+  QCommandLineOption submodesOption({"m", "submodes"}, "Submodes to benchmark, e.g., ABCE; defaults to all enabled submodes.", "submodes");
+  QCommandLineOption jobsOption    ({"j", "jobs"},     "Number of scenes to decode concurrently; defaults to 1.", "jobs");
+  QCommandLineOption freqOption    ({"f", "frequency"},"QSO frequency (Hz), decoded first; defaults to 1500.", "frequency");
+  QCommandLineOption minOption     ("min",             "Low decode limit (Hz); defaults to 0.", "frequency");
+  QCommandLineOption maxOption     ("max",             "High decode limit (Hz); defaults to 5000.", "frequency");
+  QCommandLineOption minsumOption  ("min-sum",         "Use the min-sum LDPC decoder.");
+  QCommandLineOption seedOption    ("seed",            "Random seed; defaults to 1.", "seed");
+  QCommandLineOption signalsOption ("signals",         "Signals per scene; defaults to 10.", "signals");
+  QCommandLineOption scenesOption  ("scenes",          "Scenes per submode and SNR; defaults to 2.", "scenes");
+  QCommandLineOption goldenOption  ("golden",          "Prior report; exit with status 2 if yield at any SNR has fallen.", "file");
+  QCommandLineOption syncOption    ("sync-only",       "Run only the first sync search of each scene, reporting its timings.");
+  QCommandLineOption compareOption ("compare-bp",      "Decode each scene with each of the LDPC decoders, reporting the results of each.");
+  QCommandLineOption codecOption   ("codec",           "Pack and unpack representative messages rather than decoding, reporting throughput as JSON.", "iterations");
+
+  parser.addOptions({submodesOption,
+                     jobsOption,
+                     freqOption,
+                     minOption,
+                     maxOption,
+                     minsumOption,
+                     seedOption,
+                     signalsOption,
+                     scenesOption,
+                     goldenOption,
+                     syncOption,
+                     compareOption,
+                     codecOption});
+  parser.process(app);
+
+  if (parser.isSet(codecOption))
+  {
+    return runCodecBenchmark(std::max(parser.value(codecOption).toInt(), 1));
+  }
+
+  Options   options;
+  Benchmark benchmark;
+
+  options.nfqso  = parser.isSet(freqOption) ? parser.value(freqOption).toInt() : options.nfqso;
+  options.nfa    = parser.isSet(minOption) ? parser.value(minOption).toInt() : options.nfa;
+  options.nfb    = parser.isSet(maxOption) ? parser.value(maxOption).toInt() : options.nfb;
+  options.minsum = parser.isSet(minsumOption);
+
+  for (auto const & submode : SUBMODES)
+  {
+    if (parser.isSet(submodesOption)
+      ? parser.value(submodesOption).contains(QChar(submode.letter), Qt::CaseInsensitive)
+      : submode.enabled)
+    {
+      options.submodes.push_back(submode.submode);
+    }
+  }
+
+  if (options.submodes.empty()) parser.showHelp(1);
+
+  benchmark.seed        = parser.isSet(seedOption)    ? parser.value(seedOption).toUInt()   : benchmark.seed;
+  benchmark.signalCount = parser.isSet(signalsOption) ? parser.value(signalsOption).toInt() : benchmark.signalCount;
+  benchmark.scenes      = parser.isSet(scenesOption)  ? parser.value(scenesOption).toInt()  : benchmark.scenes;
+  benchmark.syncOnly    = parser.isSet(syncOption);
+  benchmark.compareBP   = parser.isSet(compareOption);
+  benchmark.golden      = parser.value(goldenOption);
+
+  // Timings are most comparable when scenes are decoded one at a time,
+  // so unless asked otherwise, that's what we'll do.
+
+  auto const jobs   = parser.isSet(jobsOption) ? parser.value(jobsOption).toInt() : 1;
+  auto const status = benchmark.syncOnly ? runSyncBenchmark(jobs, options, benchmark)
+                                         : runBenchmark    (jobs, options, benchmark);
+
+  FFTW::cleanup();
+
+  return status;
+}
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <locale.h>
+#include <QAudioFormat>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include "Audio/BWFFile.hpp"
+#include "commons.h"
+#include "Decimator.hpp"
+#include "decodedtext.h"
+#include "FFTW.hpp"
+#include "JS8.hpp"
+#include "JS8Submode.hpp"
+#include "varicode.h"
+
+// Offline decoder for recorded audio; decodes WAV / BWF files, either
+// at 12kHz or at 48kHz, for all requested submodes, printing decodes
+// to standard output as text or as JSON, one decode per line. Files
+// are decoded concurrently, but output is always in file order, so
+// that the output of different builds can be compared directly.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  // Submodes we know how to decode, along with the letter used to select
+  // each of them on the command line.
+
+  struct Submode
+  {
+    char letter;
+    int  submode;
+    bool enabled;
+  };
+
+  constexpr std::array SUBMODES
+  {
+    Submode{'A', Varicode::JS8CallNormal, JS8_ENABLE_JS8A},
+    Submode{'B', Varicode::JS8CallFast,   JS8_ENABLE_JS8B},
+    Submode{'C', Varicode::JS8CallTurbo,  JS8_ENABLE_JS8C},
+    Submode{'E', Varicode::JS8CallSlow,   JS8_ENABLE_JS8E},
+    Submode{'I', Varicode::JS8CallUltra,  JS8_ENABLE_JS8I}
+  };
+
+  // Bit used for the submode in the decoder's nsubmodes bitset; normal
+  // mode's identifier is zero, so it's special.
+
+  constexpr int
+  submodeBit(int const submode)
+  {
+    return submode ? submode << 1 : 1;
+  }
+
+  // Options that apply to every file.
+
+  struct Options
+  {
+    std::vector<int> submodes;
+    int              nfqso  = 1500;
+    int              nfa    = 0;
+    int              nfb    = 5000;
+    bool             minsum = false;
+    bool             json   = false;
+  };
+
+  // Determine the time of the first sample in the file. We'll use the
+  // origination time in the 'bext' chunk, if there is one, otherwise
+  // the time encoded in the file name, if it's one we recognize, e.g.,
+  // `250101_123000.wav`, otherwise midnight, in which case times will
+  // at least be relative to the start of the file.
+
+  QTime
+  startTime(BWFFile   const & file,
+            QFileInfo const & info)
+  {
+    if (auto const dateTime = file.bext_origination_date_time();
+                   dateTime.isValid())
+    {
+      return dateTime.time();
+    }
+
+    static QRegularExpression const pattern(R"((?:^|_)(\d{2})(\d{2})(\d{2})$)");
+
+    if (auto const match = pattern.match(info.completeBaseName());
+                   match.hasMatch())
+    {
+      if (auto const time = QTime(match.captured(1).toInt(),
+                                  match.captured(2).toInt(),
+                                  match.captured(3).toInt());
+                     time.isValid())
+      {
+        return time;
+      }
+    }
+
+    return QTime(0, 0);
+  }
+
+  // Read the samples from the file, decimating them to 12kHz if they
+  // were recorded at any other rate we can decimate from; if there's more
+  // than one channel, we use the first of them. Samples must be 16-bit
+  // integers. Throws on anything we can't handle.
+
+  std::vector<std::int16_t>
+  readSamples(BWFFile & file)
+  {
+    auto const & format   = file.format();
+    auto const   channels = std::max(format.channelCount(), 1);
+    auto const   rate     = format.sampleRate();
+
+    if (format.sampleFormat() != QAudioFormat::Int16)
+    {
+      throw std::runtime_error("unsupported sample format; samples must be 16-bit integers");
+    }
+
+    if (rate != JS8_RX_SAMPLE_RATE && !(rate > 0 && Decimator::supports(rate)))
+    {
+      throw std::runtime_error(QString("unsupported sample rate %1").arg(rate).toStdString());
+    }
+
+    auto const data   = file.readAll();
+    auto const frames = data.size() / static_cast<qsizetype>(sizeof(std::int16_t) * channels);
+    auto const input  = reinterpret_cast<std::int16_t const *>(data.constData());
+
+    std::vector<std::int16_t> samples;
+
+    samples.reserve(frames);
+
+    for (qsizetype i = 0; i < frames; ++i) samples.push_back(input[i * channels]);
+
+    if (rate != JS8_RX_SAMPLE_RATE)
+    {
+      Decimator                 decimator(rate);
+      std::vector<std::int16_t> decimated(decimator.produced(samples.size()));
+
+      decimator.process(samples.data(), samples.size(), decimated.data());
+
+      samples = std::move(decimated);
+    }
+
+    return samples;
+  }
+
+  // Format a decode, as text or as JSON, for output.
+
+  QByteArray
+  format(Options             const & options,
+         QFileInfo           const & info,
+         JS8::Event::Decoded const & decoded)
+  {
+    DecodedText const text(decoded);
+
+    if (options.json)
+    {
+      return QJsonDocument(QJsonObject
+      {
+        {"file",      info.filePath()},
+        {"utc",       decoded.utc},
+        {"snr",       decoded.snr},
+        {"dt",        decoded.xdt},
+        {"frequency", decoded.frequency},
+        {"submode",   JS8::Submode::name(decoded.mode)},
+        {"frame",     text.frame()},
+        {"bits",      decoded.type},
+        {"quality",   decoded.quality},
+        {"message",   text.message()}
+      }).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    return QString("%1 %2 %3\n").arg(info.filePath(),
+                                     text.string().trimmed(),
+                                     text.message()).toUtf8();
+  }
+
+  // Decode a file, returning the output for it. Each period present in
+  // its entirety within the file is decoded, for each requested submode.
+
+  QByteArray
+  decode(JS8::OfflineDecoder       & decoder,
+         Options             const & options,
+         QString             const & path)
+  {
+    QFileInfo const info(path);
+    BWFFile         file(QAudioFormat{}, path);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+      throw std::runtime_error(file.errorString().toStdString());
+    }
+
+    auto const start   = startTime(file, info);
+    auto const samples = readSamples(file);
+    auto const size    = static_cast<int>(samples.size());
+
+    QByteArray output;
+
+    for (auto const submode : options.submodes)
+    {
+      int const cycle  = JS8::Submode::framesPerCycle(submode);
+      int const needed = JS8::Submode::framesNeeded(submode);
+
+      // Align periods to the start of the file; recordings made by the
+      // application start at the top of a period.
+
+      for (int pos = 0; pos + needed <= size; pos += cycle)
+      {
+        auto const time = start.addMSecs(static_cast<int>(pos * 1000LL / JS8_RX_SAMPLE_RATE));
+
+        decoder.decode(samples.data() + pos,
+                       std::min(cycle, size - pos),
+                       {
+                         .nsubmodes = submodeBit(submode),
+                         .nutc      = code_time(time.hour(), time.minute(), time.second()),
+                         .nfqso     = options.nfqso,
+                         .nfa       = options.nfa,
+                         .nfb       = options.nfb,
+                         .minsum    = options.minsum
+                       },
+                       [&](JS8::Event::Variant const & event)
+                       {
+                         if (auto const decoded = std::get_if<JS8::Event::Decoded>(&event))
+                         {
+                           output += format(options, info, *decoded);
+                         }
+                       });
+      }
+    }
+
+    return output;
+  }
+
+  // Expand the paths provided on the command line to a list of files;
+  // directories are searched recursively for WAV files, which are then
+  // sorted such that output is in a predictable order.
+
+  QStringList
+  expand(QStringList const & paths)
+  {
+    QStringList files;
+
+    for (auto const & path : paths)
+    {
+      if (QFileInfo(path).isDir())
+      {
+        QStringList found;
+        QDirIterator it(path,
+                        {"*.wav", "*.WAV"},
+                        QDir::Files,
+                        QDirIterator::Subdirectories);
+
+        while (it.hasNext()) found << it.next();
+
+        found.sort();
+        files << found;
+      }
+      else
+      {
+        files << path;
+      }
+    }
+
+    return files;
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main(int    argc,
+     char * argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  setlocale(LC_NUMERIC, "C");
+
+  app.setApplicationName("js8decode");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Decodes JS8 signals in recorded 12kHz or 48kHz WAV files.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("paths", "WAV files, or directories containing them.", "paths...");
+
+  QCommandLineOption submodesOption({"m", "submodes"}, "Submodes to decode, e.g., ABCE; defaults to all enabled submodes.", "submodes");
+  QCommandLineOption jobsOption    ({"j", "jobs"},     "Number of files to decode concurrently; defaults to the number of cores.", "jobs");
+  QCommandLineOption freqOption    ({"f", "frequency"},"QSO frequency (Hz), decoded first; defaults to 1500.", "frequency");
+  QCommandLineOption minOption     ("min",             "Low decode limit (Hz); defaults to 0.", "frequency");
+  QCommandLineOption maxOption     ("max",             "High decode limit (Hz); defaults to 5000.", "frequency");
+  QCommandLineOption minsumOption  ("min-sum",         "Use the min-sum LDPC decoder.");
+  QCommandLineOption jsonOption    ("json",            "Output decodes as JSON, one object per line.");
+
+  parser.addOptions({submodesOption,
+                     jobsOption,
+                     freqOption,
+                     minOption,
+                     maxOption,
+                     minsumOption,
+                     jsonOption});
+  parser.process(app);
+
+  Options options;
+
+  options.nfqso  = parser.isSet(freqOption) ? parser.value(freqOption).toInt() : options.nfqso;
+  options.nfa    = parser.isSet(minOption) ? parser.value(minOption).toInt() : options.nfa;
+  options.nfb    = parser.isSet(maxOption) ? parser.value(maxOption).toInt() : options.nfb;
+  options.minsum = parser.isSet(minsumOption);
+  options.json   = parser.isSet(jsonOption);
+
+  for (auto const & submode : SUBMODES)
+  {
+    if (parser.isSet(submodesOption)
+      ? parser.value(submodesOption).contains(QChar(submode.letter), Qt::CaseInsensitive)
+      : submode.enabled)
+    {
+      options.submodes.push_back(submode.submode);
+    }
+  }
+
+  auto const files = expand(parser.positionalArguments());
+
+  if (files.isEmpty() || options.submodes.empty())
+  {
+    parser.showHelp(1);
+  }
+
+  // Decode files concurrently; each job owns a decoder, and takes the next
+  // file until there are none left. Output for each file is released in
+  // file order as it becomes available, in the same manner as the decoder
+  // releases events in dispatch order.
+
+  struct Result
+  {
+    QByteArray output;
+    QString    error;
+    bool       done = false;
+  };
+
+  auto const jobs = std::clamp(parser.isSet(jobsOption) ? parser.value(jobsOption).toInt()
+                                                        : QThread::idealThreadCount(),
+                               1,
+                               static_cast<int>(files.size()));
+
+  std::vector<Result>      results(files.size());
+  std::atomic<qsizetype>   next = 0;
+  std::mutex               mutex;
+  std::condition_variable  condition;
+  QThreadPool              pool;
+
+  pool.setMaxThreadCount(jobs);
+
+  for (int job = 0; job < jobs; ++job)
+  {
+    pool.start([&]()
+    {
+      JS8::OfflineDecoder decoder;
+
+      for (auto index = next++; index < files.size(); index = next++)
+      {
+        Result result;
+
+        try
+        {
+          result.output = decode(decoder, options, files[index]);
+        }
+        catch (std::exception const & e)
+        {
+          result.error = QString("%1: %2").arg(files[index], e.what());
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          results[index]      = std::move(result);
+          results[index].done = true;
+        }
+
+        condition.notify_one();
+      }
+    });
+  }
+
+  int status = 0;
+
+  for (auto & result : results)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    condition.wait(lock, [&result] { return result.done; });
+
+    std::cout << result.output.constData() << std::flush;
+
+    if (!result.error.isEmpty())
+    {
+      std::cerr << result.error.toLocal8Bit().constData() << std::endl;
+      status = 1;
+    }
+
+    result.output.clear();
+  }
+
+  pool.waitForDone();
+
+  FFTW::cleanup();
+
+  return status;
+}
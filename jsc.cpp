@@ -21,35 +21,263 @@
 #include "jsc.h"
 #include "varicode.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <QDebug>
-#include <QCache>
 
-QMap<QString, quint32> LOOKUP_CACHE;
+namespace
+{
+    // Double-array trie over the words reachable through the prefix table,
+    // built on first use. Each unit is a node; the child of node s by byte
+    // c is unit t = base(s) + c, provided that check(t) is s. A node that
+    // ends a word carries the word's position in the list, its rank, and
+    // its index in the map, its value.
+    //
+    // A lookup walks the trie along the input, one unit per byte, and of
+    // the words it passes through, answers the one that comes first in the
+    // list, which is what a linear scan of the prefix's slice of the list
+    // would find. Lookups are therefore proportional to the length of the
+    // word at most, allocate nothing, and are safe from any thread.
+
+    class Trie
+    {
+        struct Unit
+        {
+            qint32  base  = 0;
+            qint32  check = FREE;
+            quint32 rank  = NONE;
+            quint32 value = 0;
+        };
+
+        struct Key
+        {
+            std::string_view word;
+            quint32          rank;
+            quint32          value;
+
+            bool operator<(Key const & other) const
+            {
+                return word != other.word ? word < other.word : rank < other.rank;
+            }
+        };
 
-Codeword JSC::codeword(quint32 index, bool separate, quint32 bytesize, quint32 s, quint32 c){
-    QList<Codeword> out;
+        static constexpr qint32  FREE = -1;
+        static constexpr qint32  ROOT = -2;
+        static constexpr quint32 NONE = std::numeric_limits<quint32>::max();
 
-    quint32 v = ((index % s) << 1) + (quint32)separate;
-    out.prepend(Varicode::intToBits(v, bytesize + 1));
+        std::vector<Unit> m_units;
+        std::size_t       m_next = 1;
+
+        // Grow the units such that position t exists.
+
+        void reserve(std::size_t const t)
+        {
+            if (t >= m_units.size()) m_units.resize(std::max(t + 1, m_units.size() * 2));
+        }
+
+        // Find a base at which all the labels provided land on free units.
+        // The scan starts from the first free unit; if it finds the region
+        // from there almost entirely used, it skips past it for next time,
+        // as the double-array construction in Darts does, which keeps the
+        // construction from going quadratic.
+
+        qint32 place(std::vector<unsigned char> const & labels)
+        {
+            std::size_t used = 0;
+
+            for (auto pos = std::max<std::size_t>(m_next, labels.front());; ++pos)
+            {
+                reserve(pos);
+
+                if (m_units[pos].check != FREE)
+                {
+                    ++used;
+                    continue;
+                }
+
+                auto const base = static_cast<qint32>(pos - labels.front());
+
+                if (std::all_of(labels.begin(), labels.end(), [&](auto const label)
+                {
+                    reserve(base + label);
+                    return m_units[base + label].check == FREE;
+                }))
+                {
+                    if (used * 20 >= (pos - m_next + 1) * 19) m_next = pos;
+                    return base;
+                }
+            }
+        }
+
+        // Insert the keys in [first, last), all of which share the first
+        // depth bytes, beneath the unit for that prefix. The keys are sorted,
+        // so any that end here come first, the lowest ranked of them first.
+
+        void insert(std::size_t       const   unit,
+                    std::size_t       const   depth,
+                    std::vector<Key> const  & keys,
+                    std::size_t               first,
+                    std::size_t       const   last)
+        {
+            if (keys[first].word.size() == depth)
+            {
+                m_units[unit].rank  = keys[first].rank;
+                m_units[unit].value = keys[first].value;
+
+                while (first < last && keys[first].word.size() == depth) ++first;
+            }
+
+            if (first == last) return;
+
+            std::vector<unsigned char> labels;
+
+            for (auto i = first; i < last; ++i)
+            {
+                auto const label = static_cast<unsigned char>(keys[i].word[depth]);
+                if (labels.empty() || labels.back() != label) labels.push_back(label);
+            }
+
+            auto const base = place(labels);
+
+            m_units[unit].base = base;
+
+            for (auto const label : labels) m_units[base + label].check = static_cast<qint32>(unit);
+
+            while (m_next < m_units.size() && m_units[m_next].check != FREE) ++m_next;
+
+            for (auto const label : labels)
+            {
+                auto const begin = first;
+
+                while (first < last && static_cast<unsigned char>(keys[first].word[depth]) == label) ++first;
+
+                insert(base + label, depth + 1, keys, begin, first);
+            }
+        }
+
+    public:
+
+        // Build from the prefix table; only the first entry for a given
+        // leading character is ever consulted, and within its slice of the
+        // list, only words that begin with that character can match. A
+        // slice of one is the word for the character itself, and matches
+        // on that character alone.
+
+        Trie()
+        {
+            std::vector<Key> keys;
+            bool             seen[256] = {};
+
+            for (quint32 i = 0; i < JSC::prefixSize; i++)
+            {
+                auto const c = static_cast<unsigned char>(JSC::prefix[i].str[0]);
+
+                if (!c || std::exchange(seen[c], true)) continue;
+
+                auto const index = static_cast<quint32>(JSC::prefix[i].index);
+                auto const count = static_cast<quint32>(JSC::prefix[i].size);
+
+                if (count == 1)
+                {
+                    keys.push_back({std::string_view(JSC::prefix[i].str, 1), index, static_cast<quint32>(JSC::list[index].index)});
+                    continue;
+                }
+
+                for (auto j = index; j < index + count; j++)
+                {
+                    std::string_view const word(JSC::list[j].str, JSC::list[j].size);
+
+                    if (word.empty() || static_cast<unsigned char>(word.front()) != c) continue;
+
+                    keys.push_back({word, j, static_cast<quint32>(JSC::list[j].index)});
+                }
+            }
+
+            std::sort(keys.begin(), keys.end());
+
+            m_units.resize(1024);
+            m_units.front().check = ROOT;
+
+            if (!keys.empty()) insert(0, 0, keys, 0, keys.size());
+
+            while (!m_units.empty() && m_units.back().check == FREE) m_units.pop_back();
+
+            m_units.shrink_to_fit();
+        }
+
+        // Look up a word, presented as a function returning each successive
+        // byte of it, or zero at the end of it.
+
+        template <typename Next>
+        bool find(Next      && next,
+                  quint32    & value) const
+        {
+            quint32     rank = NONE;
+            std::size_t unit = 0;
+
+            while (unsigned char const c = next())
+            {
+                auto const child = static_cast<std::size_t>(m_units[unit].base) + c;
+
+                if (child >= m_units.size() || m_units[child].check != static_cast<qint32>(unit)) break;
+
+                unit = child;
+
+                if (m_units[unit].rank < rank)
+                {
+                    rank  = m_units[unit].rank;
+                    value = m_units[unit].value;
+                }
+            }
+
+            return rank != NONE;
+        }
+    };
+
+    Trie const & trie()
+    {
+        static Trie const trie;
+        return trie;
+    }
+}
+
+Codeword JSC::codeword(quint32 index, bool separate, quint32 bytesize, quint32 s, quint32 c){
+    // continuers are computed last first, but sent first
+    quint32 continuers[32];
+    int n = 0;
 
     quint32 x = index / s;
     while(x > 0){
         x -= 1;
-        out.prepend(Varicode::intToBits((x % c) + s, bytesize));
+        continuers[n++] = (x % c) + s;
         x /= c;
     }
 
     Codeword word;
-    foreach(auto w, out){
-        word.append(w);
+    while(n > 0){
+        word += Varicode::intToBits(continuers[--n], bytesize);
     }
 
+    quint32 v = ((index % s) << 1) + (quint32)separate;
+    word += Varicode::intToBits(v, bytesize + 1);
+
     return word;
 }
 
 QList<CodewordPair> JSC::compress(QString text){
+    return compress(text, -1, nullptr);
+}
+
+// compress only as much of the text as it takes for the codewords to come
+// to at least the number of bits provided, or all of it if that's negative,
+// noting how many characters had to be looked at; the codewords are those
+// that compressing all of the text would start with
+QList<CodewordPair> JSC::compress(QStringView text, int bits, qsizetype *pExamined){
     QList<CodewordPair> out;
 
     const quint32 b = 4;
@@ -58,15 +286,19 @@ QList<CodewordPair> JSC::compress(QString text){
 
     QString space(" ");
 
-    QStringList words = text.split(" ", Qt::KeepEmptyParts);
+    int total = 0;
+    qsizetype examined = text.size();
 
-    for(int i = 0, len = words.length(); i < len; i++){
-        QString w = words[i];
+    // words are as split by spaces, keeping empty parts
+    for(qsizetype pos = 0; ; ){
+        auto const end = text.indexOf(u' ', pos);
 
-        bool isLastWord = (i == len - 1);
+        bool isLastWord = (end == -1);
         bool ok = false;
         bool isSpaceCharacter = false;
 
+        QString w = text.sliced(pos, (isLastWord ? text.size() : end) - pos).toString();
+
         // if this is an empty part, it should be a space, unless its the last word.
         if(w.isEmpty() && !isLastWord){
             w = space;
@@ -88,9 +320,24 @@ QList<CodewordPair> JSC::compress(QString text){
             bool shouldAppendSpace = isLast && !isSpaceCharacter && !isLastWord;
 
             out.append({ codeword(index, shouldAppendSpace, b, s, c), (quint32)t.size + (shouldAppendSpace ? 1 : 0) /* for the space that follows */});
+
+            total += out.last().first.size();
+            if(bits >= 0 && total >= bits){
+                break;
+            }
+        }
+
+        // the codewords for a word depend on it and on whether there's a space after it
+        if(isLastWord || (bits >= 0 && total >= bits)){
+            if(!isLastWord) examined = end + 1;
+            break;
         }
+
+        pos = end + 1;
     }
 
+    if(pExamined) *pExamined = examined;
+
     return out;
 }
 
@@ -115,13 +362,12 @@ QString JSC::decompress(Codeword const& bitvec){
     QList<quint32> separators;
 
     int i = 0;
-    int count = bitvec.count();
+    int count = bitvec.size();
     while(i < count){
-        auto b = bitvec.mid(i, 4);
-        if(b.length() != 4){
+        if(count - i < 4){
             break;
         }
-        quint64 byte = Varicode::bitsToInt(b);
+        quint64 byte = bitvec.read(i, 4);
         bytes.append(byte);
         i += 4;
 
@@ -177,62 +423,31 @@ bool JSC::exists(QString w, quint32 *pIndex){
     return found && JSC::map[index].size == w.length();
 }
 
-quint32 JSC::lookup(QString w, bool * ok){
-    if(LOOKUP_CACHE.contains(w)){
-        if(ok) *ok = true;
-        return LOOKUP_CACHE[w];
-    }
+// Characters outside of Latin-1 are presented as '?', as QString::toLatin1()
+// would convert them, and the word ends at the first NUL, if any.
 
-    bool found = false;
-    quint32 result = lookup(w.toLatin1().data(), &found);
-    if(found){
-        LOOKUP_CACHE[w] = result;
-    }
+quint32 JSC::lookup(QString w, bool * ok){
+    quint32 value = 0;
+    auto it = w.cbegin();
+    auto const end = w.cend();
+    bool const found = trie().find([&]() -> unsigned char {
+        if(it == end){
+            return 0;
+        }
+        auto const c = (it++)->unicode();
+        return c > 0xff ? '?' : c;
+    }, value);
 
     if(ok) *ok = found;
-    return result;
+    return found ? value : 0;
 }
 
 quint32 JSC::lookup(char const* b, bool *ok){
-    quint32 index = 0;
-    quint32 count = 0;
-    bool found = false;
-
-    // first find prefix match to jump into the list faster
-    for(quint32 i = 0; i < JSC::prefixSize; i++){
-        // skip obvious non-prefixes...
-        if(b[0] != JSC::prefix[i].str[0]){
-            continue;
-        }
+    quint32 value = 0;
+    bool const found = trie().find([&b]() -> unsigned char {
+        return *b ? static_cast<unsigned char>(*b++) : 0;
+    }, value);
 
-        // ok, we found one... let's end early for single char strings.
-        if(JSC::prefix[i].size == 1){
-            if(ok) *ok = true;
-            return JSC::list[JSC::prefix[i].index].index;
-        }
-
-        // otherwise, keep track of the first index in the list and the number of elements
-        index = JSC::prefix[i].index;
-        count = JSC::prefix[i].size;
-        found = true;
-        break;
-    }
-
-    // no prefix found... no lookup
-    if(!found){
-        if(ok) *ok = false;
-        return 0;
-    }
-
-    // now that we have the first index in the list, let's just iterate through the list, comparing words along the way
-    for(quint32 i = index; i < index + count; i++){
-        quint32 len = JSC::list[i].size;
-        if(strncmp(b, JSC::list[i].str, len) == 0){
-            if(ok) *ok = true;
-            return JSC::list[i].index;
-        }
-    }
-
-    if(ok) *ok = false;
-    return 0;
+    if(ok) *ok = found;
+    return found ? value : 0;
 }
@@ -12,8 +12,10 @@
 #include <QPair>
 #include <QVector>
 
-typedef QPair<QVector<bool>, quint32> CodewordPair;        // Tuple(Codeword, N) where N = number of characters
-typedef QVector<bool> Codeword;                        // Codeword bit vector
+#include "BitStream.hpp"
+
+typedef QPair<BitStream, quint32> CodewordPair;        // Tuple(Codeword, N) where N = number of characters
+typedef BitStream Codeword;                            // Codeword bit stream
 
 typedef struct Tuple{
     char const * str;
@@ -30,6 +32,7 @@ public:
 #endif
     static Codeword codeword(quint32 index, bool separate, quint32 bytesize, quint32 s, quint32 c);
     static QList<CodewordPair> compress(QString text);
+    static QList<CodewordPair> compress(QStringView text, int bits, qsizetype *pExamined);
     static QString decompress(Codeword const& bits);
 
     static bool exists(QString w, quint32 *pIndex);
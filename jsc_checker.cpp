@@ -71,11 +71,25 @@ bool isWordChar(QString ch){
 
 void JSCChecker::checkRange(QTextEdit* edit, int start, int end)
 {
-    if(end == -1){
-        QTextCursor tmpCursor(edit->textCursor());
-        tmpCursor.movePosition(QTextCursor::End);
+    QTextCursor tmpCursor(edit->textCursor());
+    tmpCursor.movePosition(QTextCursor::End);
+    if(end == -1 || end > tmpCursor.position()){
         end = tmpCursor.position();
     }
+    start = qBound(0, start, end);
+
+    // the range may start or end partway through a word, so widen it to the
+    // whole of those words
+    tmpCursor.setPosition(start);
+    tmpCursor.movePosition(QTextCursor::StartOfWord);
+    start = tmpCursor.position();
+    if(start > 0 && edit->document()->characterAt(start - 1) == '@'){
+        start--;
+    }
+
+    tmpCursor.setPosition(end);
+    tmpCursor.movePosition(QTextCursor::EndOfWord);
+    end = tmpCursor.position();
 
     // stop contentsChange signals from being emitted due to changed charFormats
     edit->document()->blockSignals(true);
@@ -147,6 +161,33 @@ void JSCChecker::checkRange(QTextEdit* edit, int start, int end)
     edit->document()->blockSignals(false);
 }
 
+void JSCChecker::clearRange(QTextEdit* edit, int start, int end)
+{
+    QTextCursor cursor(edit->textCursor());
+    cursor.movePosition(QTextCursor::End);
+    if(end == -1 || end > cursor.position()){
+        end = cursor.position();
+    }
+    start = qBound(0, start, end);
+
+    // stop contentsChange signals from being emitted due to changed charFormats
+    edit->document()->blockSignals(true);
+
+    // merge rather than set, so only the underline goes and any other
+    // formatting (e.g., the transmitted highlight) is kept
+    QTextCharFormat defaultFormat = QTextCharFormat();
+    QTextCharFormat fmt;
+    fmt.setFontUnderline(defaultFormat.fontUnderline());
+    fmt.setUnderlineColor(defaultFormat.underlineColor());
+    fmt.setUnderlineStyle(defaultFormat.underlineStyle());
+
+    cursor.setPosition(start);
+    cursor.setPosition(end, QTextCursor::KeepAnchor);
+    cursor.mergeCharFormat(fmt);
+
+    edit->document()->blockSignals(false);
+}
+
 QSet<QString> oneEdit(QString word, bool includeAdditions, bool includeDeletions){
     QSet<QString> all;
 
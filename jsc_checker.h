@@ -16,6 +16,7 @@ public:
     explicit JSCChecker(QObject *parent = nullptr);
 
     static void checkRange(QTextEdit * edit, int start, int end);
+    static void clearRange(QTextEdit * edit, int start, int end);
     static QStringList suggestions(QString word, int n, bool *pFound);
 
 signals:
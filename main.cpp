@@ -4,7 +4,6 @@
 #include <string>
 
 #include <locale.h>
-#include <fftw3.h>
 
 #include <QDateTime>
 #include <QApplication>
@@ -31,6 +30,7 @@
 #include "MultiSettings.hpp"
 #include "mainwindow.h"
 #include "commons.h"
+#include "FFTW.hpp"
 #include "Radio.hpp"
 #include "FrequencyList.hpp"
 #include "MessageBox.hpp"       // last to avoid nasty MS macro definitions
@@ -268,8 +268,7 @@ int main(int argc, char *argv[])
         }
       while (!result && !multi_settings.exit ());
 
-      fftwf_forget_wisdom ();
-      fftwf_cleanup ();
+      FFTW::cleanup ();
 
       temp_dir.removeRecursively (); // clean up temp files
       return result;
@@ -17,7 +17,6 @@
 #include <string_view>
 #include <vector>
 #include <boost/crc.hpp>
-#include <fftw3.h>
 #include <QLineEdit>
 #include <QRegularExpressionValidator>
 #include <QRegularExpression>
@@ -58,6 +57,7 @@
 #include "soundin.h"
 #include "Modulator.hpp"
 #include "Detector.hpp"
+#include "SpectrumEngine.hpp"
 #include "plotter.h"
 #include "about.h"
 #include "widegraph.h"
@@ -84,14 +84,12 @@
 #include "JS8Submode.hpp"
 #include "EventFilter.hpp"
 #include "Geodesic.hpp"
+#include "FFTW.hpp"
 
 #include "ui_mainwindow.h"
 #include "moc_mainwindow.cpp"
 
 int volatile    itone[JS8_NUM_SYMBOLS];  // Audio tones for all Tx symbols
-struct dec_data dec_data;                // for sharing with Fortran
-struct specData specData;                // Used by plotter
-std::mutex      fftw_mutex;
 
 namespace
 {
@@ -222,84 +220,6 @@ namespace
                   array,
                   size) = '\0';
   }
-
-  // Emulation of the Fortran 'flat1' subroutine.
-
-  void
-  flat1(float const * const savg,
-        int           const iz,
-        int           const nsmo,
-        float       * const slin)
-  {
-    constexpr int x_size = 8192;
-    constexpr int nstep  = 20;
-    constexpr int nh     = nstep / 2;
-
-    // Define bounds for smoothing
-    int const ia =      nsmo / 2 + 1;
-    int const ib = iz - nsmo / 2 - 1;
-
-    std::vector<float> x(x_size, 0.0f);
-
-    // Smooth savg using median percentiles
-
-    auto const rank = std::clamp(static_cast<int>(std::round(0.5f * nsmo)), 0, nsmo - 1);
-
-    for (int i = ia; i <= ib; i += nstep)
-    {
-      auto const data = &savg[i - nsmo / 2];
-      auto       temp = std::vector<float>(data, data + nsmo);
-
-      std::nth_element(temp.begin(),
-                       temp.begin() + rank,
-                       temp.end());
-
-      x[i] = temp[rank];
-
-      std::fill(x.begin() + (i - nh),
-                x.begin() + (i + nh), x[i]);
-    }
-
-    // Extend smoothed values to boundaries
-    std::fill(x.begin(),          x.begin() + ia, x[ia]);
-    std::fill(x.begin() + ib + 1, x.begin() + iz, x[ib]);
-
-    // Compute scaling factor
-    float x0 = 0.001f * *std::max_element(x.begin() +      iz  / 10,
-                                          x.begin() + (9 * iz) / 10);
-
-    // Normalize savg to compute slin
-    for (int i = 0; i < iz; ++i) slin[i] = savg[i] / (x[i] + x0);
-  }
-
-  // Emulation of the Fortran 'smo' subroutine. However, doesn't copy the data
-  // back from b to a; rather, a is input and, b is output. Since we invariably
-  // call this twice, we can just swap the order of the arrays to achieve the
-  // same result without the extra two copy operations.
-
-  void
-  smo(float const * const a,
-      float       * const b,
-      int           const npts,
-      int           const nadd)
-  {
-    auto const nh = nadd / 2;
-
-    // Smooth the array
-    for (int i = nh; i < npts - nh; ++i)
-    {
-      float sum = 0.0f;
-      for (int j = -nh; j <= nh; ++j)
-      {
-        sum += a[i + j];
-      }
-      b[i] = sum;
-    }
-
-    // Set edges to zero
-    for (int i = 0;         i < nh;   ++i) b[i] = 0.0f; // Zero out leading edge
-    for (int i = npts - nh; i < npts; ++i) b[i] = 0.0f; // Zero out trailing edge
-  }
 }
 
 //--------------------------------------------------- MainWindow constructor
@@ -324,13 +244,16 @@ MainWindow::MainWindow(QString  const & program_info,
   // no parent so that it has a taskbar icon
   m_logDlg (new LogQSO (program_title (), m_settings, &m_config, nullptr)),
   m_lastDialFreq {0},
-  m_detector {new Detector {JS8_RX_SAMPLE_RATE, JS8_NTMAX}},
+  m_decData {new dec_data {}},
+  m_dataSinkFrames {0},
+  m_detector {new Detector {*m_decData, JS8_RX_SAMPLE_RATE, JS8_NTMAX}},
+  m_spectrum {new SpectrumEngine {*m_decData}},
   m_FFTSize {6912 / 2},         // conservative value to avoid buffer overruns
   m_soundInput {new SoundInput},
   m_modulator {new Modulator},
   m_soundOutput {new SoundOutput},
   m_notification {new NotificationAudio},
-  m_decoder {this},
+  m_decoder {*m_decData, this},
   m_secBandChanged {0},
   m_freqNominal {0},
   m_freqTxNominal {0},
@@ -339,7 +262,6 @@ MainWindow::MainWindow(QString  const & program_info,
   m_RxLog {1},      //Write Date and Time to RxLog
   m_nutc0 {999999},
   m_TRperiod {60},
-  m_inGain {0},
   m_idleMinutes {0},
   m_nSubMode {Default::SUBMODE},
   m_frequency_list_fcal_iter {m_config.frequencies ()->begin ()},
@@ -351,8 +273,6 @@ MainWindow::MainWindow(QString  const & program_info,
   m_lastMessageType {-1},
   m_tuneup {false},
   m_bTxTime {false},
-  m_ihsym {0},
-  m_px {0.0},
   m_iptt0 {0},
   m_btxok0 {false},
   m_onAirFreq0 {0.0},
@@ -364,6 +284,8 @@ MainWindow::MainWindow(QString  const & program_info,
   m_txFrameCount {0},
   m_txFrameCountSent {0},
   m_txTextDirty {false},
+  m_txTextSpellchecked {false},
+  m_txFramePlanner {QSharedPointer<MessageFramePlanner>::create()},
   m_driftMsMMA { 0 },
   m_driftMsMMA_N { 0 },
   m_previousFreq {0},
@@ -415,6 +337,10 @@ MainWindow::MainWindow(QString  const & program_info,
   m_soundInput->moveToThread (&m_audioThread);
   m_detector->moveToThread (&m_audioThread);
 
+  // the waterfall spectra are computed in their own thread, so as to
+  // be isolated from both the audio thread and the GUI thread
+  m_spectrum->moveToThread (&m_spectrumThread);
+
   // notification audio operates in its own thread at a lower priority
   m_notification->moveToThread(&m_notificationAudioThread);
 
@@ -498,6 +424,11 @@ MainWindow::MainWindow(QString  const & program_info,
   connect(m_detector, &Detector::framesWritten, this, &MainWindow::dataSink);
   connect (&m_audioThread, &QThread::finished, m_detector, &QObject::deleteLater);
 
+  // hook up the spectrum engine to the detector and to us
+  connect (m_detector, &Detector::framesWritten, m_spectrum, &SpectrumEngine::process);
+  connect (m_spectrum, &SpectrumEngine::framesReady, this, &MainWindow::spectrumSink);
+  connect (&m_spectrumThread, &QThread::finished, m_spectrum, &QObject::deleteLater);
+
   // setup the waterfall
   connect(m_wideGraph.data(), &WideGraph::f11f12, this, &MainWindow::f11f12);
   connect(m_wideGraph.data(), &WideGraph::setXIT, this, &MainWindow::setXIT);
@@ -653,6 +584,16 @@ MainWindow::MainWindow(QString  const & program_info,
   repeatTimer.setInterval(1000);
   connect(&repeatTimer, &QTimer::timeout, this, &MainWindow::checkRepeat);
 
+  // Decoder statistics, when enabled, are reported once a minute, if
+  // there's been any decoding in that time.
+  m_metricsTimer.setSingleShot(false);
+  m_metricsTimer.setInterval(60 * 1000);
+  connect(&m_metricsTimer, &QTimer::timeout, this, [this](){
+      if(m_decoderMetrics.empty()) return;
+      sendNetworkMessage("DECODER.METRICS", "", m_decoderMetrics.take());
+  });
+  m_metricsTimer.start();
+
   connect(m_wideGraph.data(), &WideGraph::changeFreq, this, &MainWindow::changeFreq);
   connect(m_wideGraph.data(), &WideGraph::qsy,        this, &MainWindow::qsy);
   connect(m_wideGraph.data(), &WideGraph::drifted,    this, &MainWindow::drifted);
@@ -664,13 +605,14 @@ MainWindow::MainWindow(QString  const & program_info,
   displayDialFrequency();
   readSettings();            //Restore user's setup params
 
-  {
-    std::lock_guard<std::mutex> lock(fftw_mutex);
-    fftwf_import_wisdom_from_filename(wisdomFileName());
-  }
+  // Import FFTW wisdom and create the waterfall plan in the background;
+  // the decoder creates its own plans on its own thread as it starts.
+
+  FFTW::start(wisdomFileName(), {{FFTW::Kind::R2C, SpectrumEngine::NFFT}});
 
   m_networkThread.start(m_networkThreadPriority);
   m_audioThread.start (m_audioThreadPriority);
+  m_spectrumThread.start (m_audioThreadPriority);
   m_notificationAudioThread.start(m_notificationAudioThreadPriority);
   m_decoder.start(m_decoderThreadPriority);
 
@@ -1940,14 +1882,14 @@ void MainWindow::manualBandHop(const StationList::Station station)
 //--------------------------------------------------- MainWindow destructor
 MainWindow::~MainWindow()
 {
-  {
-    std::lock_guard<std::mutex> lock(fftw_mutex);
-    fftwf_export_wisdom_to_filename(wisdomFileName());
-  }
+  FFTW::finish(wisdomFileName());
 
   m_networkThread.quit();
   m_networkThread.wait();
 
+  m_spectrumThread.quit ();
+  m_spectrumThread.wait ();
+
   m_audioThread.quit ();
   m_audioThread.wait ();
 
@@ -2197,201 +2139,44 @@ void MainWindow::set_application_font (QFont const& font)
 //-------------------------------------------------------------- dataSink()
 void MainWindow::dataSink(qint64 frames)
 {
-    constexpr int        NMAX  = JS8_NTMAX * 12000;
-    constexpr int        nfft3 = 16384;
-    constexpr std::array nch   = {1, 2, 4, 9, 18, 36, 72};
-
-    // symspec global vars
-    static int       ja   = 0;
-    static int       k0   = 999999999;
-    static WF::SPlot ssum = {};
-    static WF::SPlot s    = {};
-
-    int k (frames);
-    if(k0 == 999999999)
-    {
-        m_ihsym = int((float)frames/(float)JS8_NSPS) * 2;
-        ja      = k;
-        k0      = k;
-    }
-
-    //qDebug() << "k" << k << "k0" << k0 << "delta" << k-k0;
-
-    // Get power, spectrum, and ihsym
-    int const nsmo = m_wideGraph->smoothYellow()-1;
+    // Spectra are computed by the spectrum engine, and arrive separately
+    // via spectrumSink(); all we need to do here is to see if it's time
+    // to decode, once there's enough in the buffer to be worth a look.
+    //
+    // If the buffer has wrapped, clear anything past the write position
+    // left over from the previous period first; doing it here, rather than
+    // on the spectrum engine's thread, orders it before any decode request
+    // that could otherwise take a snapshot of it.
 
-    // make sure the ssum global is reset every period cycle
-    static int lastCycle = -1;
-    int const  cycle     = JS8::Submode::computeCycleForDecode(m_nSubMode, k);
+    if (frames < 2048) return;
 
-    if (cycle != lastCycle)
+    if (frames < m_dataSinkFrames)
     {
-        if(JS8_DEBUG_DECODE) qDebug() << "period loop, resetting ssum";
-        ssum.fill(0.0f);
+        QMutexLocker         mutex(m_detector->getMutex());
+        dec_data_epoch_guard guard(*m_decData);
+
+        std::fill(std::begin(m_decData->d2) + frames,
+                  std::end  (m_decData->d2),  0);
     }
 
-    lastCycle = cycle;
+    m_dataSinkFrames = frames;
 
-    // cap ihsym based on the period max
-    m_ihsym = m_ihsym % (m_TRperiod * JS8_RX_SAMPLE_RATE / JS8_NSPS * 2);
+    decode(frames);
+}
 
-    int const jstep = JS8_NSPS / 2;
+//---------------------------------------------------------- spectrumSink()
+void MainWindow::spectrumSink()
+{
+    m_spectrum->setSmoothing(m_wideGraph->smoothYellow());
 
-    if (k >= 2048 &&
-        k <= NMAX)
+    m_spectrum->drain([this](SpectrumEngine::Frame const & frame)
     {
-      if (k < k0)
-      {
-        // Start a new data block
-        ja = 0;
-        ssum.fill(0.0f);
-        m_ihsym = 0;
-        std::fill(std::begin(dec_data.d2) + k,
-                  std::end  (dec_data.d2),  0);
-      }
+        m_wideGraph->averageSink(frame.savg, frame.linear ? &frame.slin : nullptr);
 
-      float gain  = pow(10.0f, 0.1f * m_inGain);
-      float sq    = 0.0f;
-      float pxmax = 0.0f;
-
-      for (int i = k0; i < k; ++i)
-      {
-        float x1 = dec_data.d2[i];
-        pxmax    = std::max(pxmax, fabs(x1));
-        sq      += x1 * x1;
-      }
-
-      m_px    = sq    > 0.0f ? 10.0f * log10(sq / (k - k0)) : 0.0f;
-      m_pxmax = pxmax > 0.0f ? 20.0f * log10(pxmax)         : 0.0f;
-
-      k0  = k;
-      ja += jstep;
-
-      // Perform real to complex FFT; note that the Fortran code performed
-      // this operation in the four2a subroutine, which contains a cache
-      // of plans. However, since the FFTW3 library itself caches, this
-      // resulted in double caching, so as an experiment we're allowing
-      // the library to handle caching.
-      //
-      // Note that the FFTW library requires all calls but for the plan
-      // execution, i.e., fftwf_execute(), to be serialized. The library
-      // doesn't require prescriptive serialization, anything will do so
-      // long as the result is one thread at a time.
-      //
-      // Providing room for an extra complex value, i.e., a pair of floats,
-      // real and imaginary parts, allows us to use the same buffer for the
-      // FFT input and output.
-      //
-      // While the memory for the FFT can come from anywhere, if we ask the
-      // library for it, it'll guarantee that it's aligned for use of SIMD
-      // instructions, which will in turn allow it to use them.
-
-      fftwf_complex * fftw_complex;
-      float         * fftw_real;
-      fftwf_plan      fftw_plan;
-      {
-        std::lock_guard<std::mutex> lock(fftw_mutex);
-
-        fftw_complex = fftwf_alloc_complex(nfft3 / 2 + 1);
-
-        if (!fftw_complex)
-        {
-          throw std::runtime_error("Failed to allocate FFT data");
-        }
-
-        fftw_real = reinterpret_cast<float *>(fftw_complex);
-        fftw_plan = fftwf_plan_dft_r2c_1d(nfft3,
-                                          fftw_real,
-                                          fftw_complex,
-                                          FFTW_ESTIMATE_PATIENT);
-
-        if (!fftw_plan)
-        {
-          fftwf_free(fftw_complex);
-          throw std::runtime_error("Failed to create FFT plan");
-        }
-      }
-
-      // Copy data and apply the window, then execute the FFT.
-
-      for (int i = 0; i < nfft3; ++i)
-      {
-        if (int j  = ja + i - nfft3;
-                j >= 0 &&
-                j < NMAX) fftw_real[i] = 0.1f * dec_data.d2[j];
-      }
+        if(ui) ui->signal_meter_widget->setValue(frame.px, frame.pxmax); // Update thermometer
 
-      ++m_ihsym;
-
-      fftwf_execute(fftw_plan);
-
-      // Process the resulting spectrum.
-
-      m_df3 = 12000.0f / nfft3;
-
-      auto const iz  = std::min(JS8_NSMAX, static_cast<int>(5000.0f / m_df3));
-      auto const cx  = reinterpret_cast<std::complex<float>*>(fftw_complex);
-      auto const fac = std::pow(1.0f / nfft3, 2.0f);
-
-      for (int i = 0; i < iz; ++i)
-      {
-        auto const sx = fac * std::norm(cx[i]);
-        ssum[i]      += sx;
-        s[i]          = 1000.0f * gain * sx;
-      }
-
-      // We're now done with the plan and the FFT storage. Even though
-      // the plan is being 'destroyed' here, the library will cache it
-      // at its discretion. As above, the calls must be serialized.
-
-      {
-        std::lock_guard<std::mutex> lock(fftw_mutex);
-        fftwf_destroy_plan(fftw_plan);
-        fftwf_free(fftw_complex);
-      }
-
-      // Update average spectra.
-
-      for (int i = 0; i < iz; ++i) specData.savg[i] = ssum[i] / m_ihsym;
-
-      if (m_ihsym % 10 == 0)
-      {
-        auto const mode4 = nch[nsmo];
-        auto const nsmo  = 4 * std::min(10 * mode4, 150);
-
-        flat1(specData.savg, iz, nsmo, specData.slin);
-
-        if (mode4 >= 2)
-        {
-          std::array<float, JS8_NSMAX> tmp;
-
-          smo(specData.slin, tmp.data(),    iz, mode4);
-          smo(tmp.data(),    specData.slin, iz, mode4);
-        }
-
-        std::fill(std::begin(specData.slin), std::begin(specData.slin) + 250, 0.0f);
-
-        auto const ia    = static_cast<int>( 500.0 / m_df3);
-        auto const ib    = static_cast<int>(2700.0 / m_df3);
-        auto const smin  = *std::min_element(std::begin(specData.slin) + ia, std::begin(specData.slin) + ib);
-        auto const smax  = *std::max_element(std::begin(specData.slin),      std::begin(specData.slin) + iz);
-        auto const scale = (smax > smin) ? 50.0f / (smax - smin) : 0.0f;
-
-        for (auto & val : specData.slin) val = std::max(0.0f, scale * (val - smin));
-      }
-    }
-    else if (k < 2048) m_ihsym = 0;
-
-    // make sure ja is equal to k so if we jump ahead in the buffer, everything resolves correctly
-    ja = k;
-
-    if(m_ihsym <= 0) return;
-
-    if(ui) ui->signal_meter_widget->setValue(m_px, m_pxmax); // Update thermometer
-
-    if(m_monitoring) m_wideGraph->dataSink(s, m_df3);
-
-    decode(k);
+        if(m_monitoring) m_wideGraph->dataSink(frame.s, frame.df);
+    });
 }
 
 void MainWindow::showSoundInError(const QString& errorMsg)
@@ -2767,6 +2552,9 @@ void MainWindow::openSettings(int tab){
         setXIT(freq());
 
         m_opCall=m_config.opCall();
+
+        // spell check may have been turned on or off
+        updateTextWordCheckerDisplay();
     }
 }
 
@@ -3405,6 +3193,7 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
 
     static qint32 maxSamples       = JS8_RX_SAMPLE_SIZE;
     static qint32 oneSecondSamples = JS8_RX_SAMPLE_RATE;
+    static qint32 earlySamples     = JS8_RX_SAMPLE_RATE;   // increment between early decodes of a partial window
 
     int decodes = 0;
 
@@ -3438,6 +3227,7 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
             qint32 const cycle             = JS8::Submode::computeAltCycleForDecode(submode, k, alt*oneSecondSamples);
             qint32 const cycleFrames       = JS8::Submode::framesPerCycle(submode);
             qint32 const cycleFramesNeeded = JS8::Submode::framesForSymbols(submode); //computeFramesNeededForDecode(submode) - oneSecondSamples;
+            qint32 const cycleFramesEarly  = JS8::Submode::framesForCostas(submode);
             qint32       cycleFramesReady  = k - (cycle * cycleFrames);
             if(cycleFramesReady < 0){
                 cycleFramesReady = k + (maxSamples - (cycle * cycleFrames));
@@ -3455,6 +3245,32 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
 
             if(JS8_DEBUG_DECODE) qDebug() << JS8::Submode::name(submode) << "alt" << alt << "cycle" << cycle << "cycle frames" << cycleFrames << "cycle start" << cycle*cycleFrames << "cycle end" << (cycle+1)*cycleFrames << "k" << k << "frames ready" << cycleFramesReady << "incremeted by" << incrementedBy;
 
+            // if early decoding is waiting on candidates in this cycle to be
+            // complete, decode as soon as they are, but no sooner; otherwise,
+            // the wait is stale, i.e., the cycle has moved on
+
+            if(m_decodePending.contains(submode)){
+                auto const pending = m_decodePending.value(submode);
+
+                if(pending.start != cycle*cycleFrames){
+                    m_decodePending.remove(submode);
+                }
+                else if(!everySecond && cycleFramesReady >= pending.sz){
+                    m_decodePending.remove(submode);
+
+                    DecodeParams d;
+                    d.submode = submode;
+                    d.start = cycle*cycleFrames;
+                    d.sz = cycleFramesReady;
+                    m_decoderQueue.append(d);
+                    decodes++;
+
+                    // keep track of last decode position
+                    m_lastDecodeStartMap[submode] = k;
+                    continue;
+                }
+            }
+
             if(everySecond && incrementedBy >= oneSecondSamples){
                 DecodeParams d;
                 d.submode = submode;
@@ -3481,6 +3297,30 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
                 m_decoderQueue.append(d);
                 decodes++;
 
+                // keep track of last decode position
+                m_lastDecodeStartMap[submode] = k;
+            }
+            else if(
+                m_config.early_decode()               &&
+                !everySecond                          &&
+                incrementedBy    >= earlySamples      &&
+                cycleFramesReady >= cycleFramesEarly  &&
+                cycleFramesReady <  cycleFramesNeeded
+            ){
+                // early decoding; once the window could hold the first two
+                // Costas arrays of a signal starting with the cycle, decode
+                // the partial window on a fixed increment. Each decode of
+                // the same window carries the sync and DT of candidates not
+                // yet complete forward to the next, and reports when they
+                // will be via DecodePending, which enqueues the final decode
+                // above.
+                DecodeParams d;
+                d.submode = submode;
+                d.start = cycle*cycleFrames;
+                d.sz = cycleFramesReady;
+                m_decoderQueue.append(d);
+                decodes++;
+
                 // keep track of last decode position
                 m_lastDecodeStartMap[submode] = k;
             }
@@ -3493,7 +3333,7 @@ bool MainWindow::decodeEnqueueReadyExperiment(qint32 k, qint32 /*k0*/){
 /**
  * @brief MainWindow::decodeProcessQueue
  *        process the decode queue by merging available decode ranges
- *        into the dec_data shared structure for the decoder to process
+ *        into the receiver's dec_data structure for the decoder to process
  * @param pSubmode - the lowest speed submode in this iteration
  * @return true if the decoder is ready to be run, false otherwise
  */
@@ -3533,7 +3373,7 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
     }
 
     // default to no submodes being decoded, then bitwise OR the modes together to decode them all at once
-    dec_data.params.nsubmodes = 0;
+    m_decData->params.nsubmodes = 0;
 
     while(!m_decoderQueue.isEmpty()){
         auto params = m_decoderQueue.front();
@@ -3548,32 +3388,35 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
             submode = params.submode;
         }
 
+        // this decode will tell us again if it's still waiting on anything
+        m_decodePending.remove(params.submode);
+
         switch(params.submode){
         case Varicode::JS8CallNormal:
-            dec_data.params.kposA = params.start;
-            dec_data.params.kszA = params.sz;
-            dec_data.params.nsubmodes |= (params.submode + 1);
+            m_decData->params.kposA = params.start;
+            m_decData->params.kszA = params.sz;
+            m_decData->params.nsubmodes |= (params.submode + 1);
             break;
         case Varicode::JS8CallFast:
-            dec_data.params.kposB = params.start;
-            dec_data.params.kszB = params.sz;
-            dec_data.params.nsubmodes |= (params.submode << 1);
+            m_decData->params.kposB = params.start;
+            m_decData->params.kszB = params.sz;
+            m_decData->params.nsubmodes |= (params.submode << 1);
             break;
         case Varicode::JS8CallTurbo:
-            dec_data.params.kposC = params.start;
-            dec_data.params.kszC = params.sz;
-            dec_data.params.nsubmodes |= (params.submode << 1);
+            m_decData->params.kposC = params.start;
+            m_decData->params.kszC = params.sz;
+            m_decData->params.nsubmodes |= (params.submode << 1);
             break;
         case Varicode::JS8CallSlow:
-            dec_data.params.kposE = params.start;
-            dec_data.params.kszE = params.sz;
-            dec_data.params.nsubmodes |= (params.submode << 1);
+            m_decData->params.kposE = params.start;
+            m_decData->params.kszE = params.sz;
+            m_decData->params.nsubmodes |= (params.submode << 1);
             break;
 #if JS8_ENABLE_JS8I
         case Varicode::JS8CallUltra:
-            dec_data.params.kposI = params.start;
-            dec_data.params.kszI = params.sz;
-            dec_data.params.nsubmodes |= (params.submode << 1);
+            m_decData->params.kposI = params.start;
+            m_decData->params.kszI = params.sz;
+            m_decData->params.nsubmodes |= (params.submode << 1);
             break;
 #endif
         }
@@ -3584,8 +3427,11 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
         return false;
     }
 
-    dec_data.params.syncStats = (m_wideGraph->shouldDisplayDecodeAttempts() || m_wideGraph->isAutoSyncEnabled());
-    dec_data.params.newdat    = 1;
+    m_decData->params.syncStats = (m_wideGraph->shouldDisplayDecodeAttempts() || m_wideGraph->isAutoSyncEnabled());
+    m_decData->params.newdat    = 1;
+    m_decData->params.minsum    = m_config.min_sum_decoder();
+    m_decData->params.early     = m_config.early_decode();
+    m_decData->params.stats     = m_config.decoder_metrics() && canSendNetworkMessage();
 
     auto const period_unsigned = JS8::Submode::period(submode);
     // Need to use a signed integer here,
@@ -3596,13 +3442,13 @@ bool MainWindow::decodeProcessQueue(qint32 *pSubmode){
     auto const imin   = t.toString("mm").toInt();
     auto const isec   = t.toString("ss").toInt();
 
-    dec_data.params.nutc = code_time(ihr, imin, isec - isec % period_unsigned);
-    dec_data.params.nfqso = freq();
-    dec_data.params.nfa   = m_wideGraph->filterEnabled() ? m_wideGraph->filterMinimum() : 0;
-    dec_data.params.nfb   = m_wideGraph->filterEnabled() ? m_wideGraph->filterMaximum() : 5000;
+    m_decData->params.nutc = code_time(ihr, imin, isec - isec % period_unsigned);
+    m_decData->params.nfqso = freq();
+    m_decData->params.nfa   = m_wideGraph->filterEnabled() ? m_wideGraph->filterMinimum() : 0;
+    m_decData->params.nfb   = m_wideGraph->filterEnabled() ? m_wideGraph->filterMaximum() : 5000;
 
-    if (dec_data.params.nutc   <  m_nutc0) m_RxLog = 1;       //Date and Time to ALL.TXT
-    if (dec_data.params.newdat == 1)       m_nutc0 = dec_data.params.nutc;
+    if (m_decData->params.nutc   <  m_nutc0) m_RxLog = 1;       //Date and Time to ALL.TXT
+    if (m_decData->params.newdat == 1)       m_nutc0 = m_decData->params.nutc;
 
     // keep track of the minimum submode
     if(pSubmode) *pSubmode = submode;
@@ -3632,14 +3478,14 @@ void MainWindow::decodeStart()
   decodeBusy(true);
 
   if(JS8_DEBUG_DECODE) qDebug() << "--> decoder starting";
-  if(JS8_DEBUG_DECODE) qDebug() << " --> kin:" << dec_data.params.kin;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> newdat:" << dec_data.params.newdat;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> nsubmodes:" << dec_data.params.nsubmodes;
-  if(JS8_DEBUG_DECODE) qDebug() << " --> A:" << dec_data.params.kposA << dec_data.params.kposA + dec_data.params.kszA << QString("(%1)").arg(dec_data.params.kszA);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> B:" << dec_data.params.kposB << dec_data.params.kposB + dec_data.params.kszB << QString("(%1)").arg(dec_data.params.kszB);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> C:" << dec_data.params.kposC << dec_data.params.kposC + dec_data.params.kszC << QString("(%1)").arg(dec_data.params.kszC);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> E:" << dec_data.params.kposE << dec_data.params.kposE + dec_data.params.kszE << QString("(%1)").arg(dec_data.params.kszE);
-  if(JS8_DEBUG_DECODE) qDebug() << " --> I:" << dec_data.params.kposI << dec_data.params.kposI + dec_data.params.kszI << QString("(%1)").arg(dec_data.params.kszI);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> kin:" << m_decData->params.kin;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> newdat:" << m_decData->params.newdat;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> nsubmodes:" << m_decData->params.nsubmodes;
+  if(JS8_DEBUG_DECODE) qDebug() << " --> A:" << m_decData->params.kposA << m_decData->params.kposA + m_decData->params.kszA << QString("(%1)").arg(m_decData->params.kszA);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> B:" << m_decData->params.kposB << m_decData->params.kposB + m_decData->params.kszB << QString("(%1)").arg(m_decData->params.kszB);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> C:" << m_decData->params.kposC << m_decData->params.kposC + m_decData->params.kszC << QString("(%1)").arg(m_decData->params.kszC);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> E:" << m_decData->params.kposE << m_decData->params.kposE + m_decData->params.kszE << QString("(%1)").arg(m_decData->params.kszE);
+  if(JS8_DEBUG_DECODE) qDebug() << " --> I:" << m_decData->params.kposI << m_decData->params.kposI + m_decData->params.kszI << QString("(%1)").arg(m_decData->params.kszI);
 
   m_decoder.decode();
 }
@@ -3674,8 +3520,8 @@ MainWindow::decodeDone()
   // critical section
   QMutexLocker mutex(m_detector->getMutex());
 
-  dec_data.params.newdat = false;
-  m_RxLog                = 0;
+  m_decData->params.newdat = false;
+  m_RxLog                  = 0;
 
   // cleanup old cached messages (messages > submode period old)
 
@@ -3785,6 +3631,17 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
           }
         }
       }
+      else if constexpr (std::is_same_v<T, JS8::Event::DecodePending>)
+      {
+        // Early decoding has candidates in this window that will be complete
+        // once it's reached the size provided; decode it again at that point.
+
+        m_decodePending[e.mode] = DecodeParams{e.mode, e.position, e.size};
+      }
+      else if constexpr (std::is_same_v<T, JS8::Event::Stats>)
+      {
+        m_decoderMetrics.record(e);
+      }
       else if constexpr (std::is_same_v<T, JS8::Event::DecodeFinished>)
       {
          if(JS8_DEBUG_DECODE) qDebug() << "decode duration" << m_decoderBusyStartTime.msecsTo(QDateTime::currentDateTimeUtc()) << "ms";
@@ -3837,7 +3694,7 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
         // decode period.
         //
         // Note: Success here depends on decodes ordered such that frequencies
-        //       near `dec_data.params.nfqso` arrive here first, so it's key to
+        //       near `m_decData->params.nfqso` arrive here first, so it's key to
         //       process the decode candidates in an ordered manner, likely by
         //       sorting the raw take from the initial selection pass.
 
@@ -3888,7 +3745,7 @@ MainWindow::processDecodeEvent(JS8::Event::Variant const & event)
 
             qint32 periodMs = 1000 * JS8::Submode::period(m);
 
-            //writeNoticeTextToUI(now, QString("Decode at %1 (kin: %2, lastDecoded: %3)").arg(syncStart).arg(dec_data.params.kin).arg(m_lastDecodeStartMap.value(m)));
+            //writeNoticeTextToUI(now, QString("Decode at %1 (kin: %2, lastDecoded: %3)").arg(syncStart).arg(m_decData->params.kin).arg(m_lastDecodeStartMap.value(m)));
 
             float expectedStartDelay = JS8::Submode::startDelayMS(m) / 1000.0;
 
@@ -6055,6 +5912,7 @@ MainWindow::setupJS8()
   Q_EMIT FFTSize (m_FFTSize);
   setup_status_bar ();
   m_TRperiod = JS8::Submode::period(m_nSubMode);
+  m_spectrum->setSubmode(m_nSubMode);
   m_wideGraph->show();
 
   Q_ASSERT(JS8_NTMAX == 60);
@@ -7893,7 +7751,8 @@ void MainWindow::refreshTextDisplay(){
         text,
         forceIdentify,
         forceData,
-        m_nSubMode
+        m_nSubMode,
+        m_txFramePlanner
     );
 
     connect(t, &BuildMessageFramesThread::finished, t, &QObject::deleteLater);
@@ -7914,11 +7773,33 @@ void MainWindow::refreshTextDisplay(){
 }
 
 void MainWindow::updateTextWordCheckerDisplay(){
+    // the changed range is taken either way, so it doesn't pile up while
+    // spell check is off
+    auto [start, end] = ui->extFreeTextMsgEdit->takeChangedRange();
+
     if(!m_config.spellcheck()){
+        // spell check was turned off; drop the underlines it left behind
+        if(m_txTextSpellchecked){
+            JSCChecker::clearRange(ui->extFreeTextMsgEdit, 0, -1);
+            m_txTextSpellchecked = false;
+        }
+        return;
+    }
+
+    // spell check was (re)enabled; nothing in the document has been checked
+    // yet, so check all of it once
+    if(!m_txTextSpellchecked){
+        start = 0;
+        end = -1;
+        m_txTextSpellchecked = true;
+    }
+
+    // otherwise, only the words that have changed since the last check need checking
+    if(start < 0){
         return;
     }
 
-    JSCChecker::checkRange(ui->extFreeTextMsgEdit, 0, -1);
+    JSCChecker::checkRange(ui->extFreeTextMsgEdit, start, end);
 }
 
 void MainWindow::updateTextStatsDisplay(QString text, int count){
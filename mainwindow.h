@@ -55,6 +55,7 @@
 #include "NotificationAudio.h"
 #include "ProcessThread.h"
 #include "JS8.hpp"
+#include "DecoderMetrics.hpp"
 #include "StationList.hpp"
 
 extern int volatile itone[JS8_NUM_SYMBOLS];   //Audio tones for all Tx symbols
@@ -78,6 +79,7 @@ class SoundOutput;
 class Modulator;
 class SoundInput;
 class Detector;
+class SpectrumEngine;
 class MultiSettings;
 class DecodedText;
 class JSCChecker;
@@ -117,6 +119,7 @@ public slots:
   void showSoundOutError(const QString& errorMsg);
   void showStatusMessage(const QString& statusMsg);
   void dataSink(qint64 frames);
+  void spectrumSink();
   void guiUpdate();
   void setXIT(int n);
   void qsy(int hzDelta);
@@ -412,7 +415,10 @@ private:
   Frequency  m_lastDialFreq;
   QString m_lastBand;
 
+  QScopedPointer<dec_data> m_decData;
+  qint64 m_dataSinkFrames;          // frame count at the last dataSink()
   Detector * m_detector;
+  SpectrumEngine * m_spectrum;
   unsigned m_FFTSize;
   SoundInput * m_soundInput;
   Modulator * m_modulator;
@@ -421,6 +427,7 @@ private:
 
   QThread m_networkThread;
   QThread m_audioThread;
+  QThread m_spectrumThread;
   QThread m_notificationAudioThread;
   JS8::Decoder m_decoder;
 
@@ -436,7 +443,6 @@ private:
   qint32  m_RxLog;
   qint32  m_nutc0;
   qint32  m_TRperiod;
-  qint32  m_inGain;
   qint32  m_idleMinutes;
   qint32  m_nSubMode;
   FrequencyList_v2::const_iterator m_frequency_list_fcal_iter;
@@ -459,10 +465,6 @@ private:
   bool    m_tuneup;
   bool    m_bTxTime;
 
-  int			m_ihsym;
-  float		m_px;
-  float   m_pxmax;
-  float		m_df3;
   quint32 m_iptt = 0;
   quint32 m_iptt0;
   bool		m_btxok0;
@@ -491,6 +493,7 @@ private:
   QTimer TxAgainTimer;
   QTimer minuteTimer;
   QTimer repeatTimer;
+  QTimer m_metricsTimer;
 
   QString m_baseCall;
   QString m_hisCall;
@@ -574,8 +577,10 @@ private:
   int m_txFrameCountSent;
   QTimer m_txTextDirtyDebounce;
   bool m_txTextDirty;
+  bool m_txTextSpellchecked;
   QString m_txTextDirtyLastText;
   QString m_txTextDirtyLastSelectedCall;
+  QSharedPointer<MessageFramePlanner> m_txFramePlanner;
   QString m_lastTxMessage;
   QString m_totalTxMessage;
   QDateTime m_lastTxStartTime;
@@ -644,6 +649,8 @@ private:
   using BandActivity = QMap<int, QList<ActivityDetail>>;
 
   QQueue<DecodeParams> m_decoderQueue;
+  QMap<qint32, DecodeParams> m_decodePending; // submode -> window to decode once size frames are ready
+  DecoderMetrics m_decoderMetrics; // decoder statistics since the last metrics message
   FrameCache  m_messageDupeCache; // submode, frame -> date seen
   QVariantMap m_showColumnsCache; // table column:key -> show boolean
   QVariantMap m_sortCache; // table key -> sort by
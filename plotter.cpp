@@ -10,7 +10,6 @@
 #include <QPen>
 #include <QToolTip>
 #include <QWheelEvent>
-#include "commons.h"
 #include "moc_plotter.cpp"
 #include "DriftingDateTime.h"
 #include "JS8Submode.hpp"
@@ -136,12 +135,42 @@ CPlotter::sizeHint() const
 }
 
 void
-CPlotter::paintEvent(QPaintEvent *)
+CPlotter::paintEvent(QPaintEvent * event)
 {
   QPainter p(this);
 
   p.drawPixmap(0, 0,    m_ScalePixmap);
-  p.drawPixmap(0, 30,   m_WaterfallPixmap);
+
+  // The waterfall image is a ring of rows, the newest of which is the
+  // current row; draw the rows from there to the bottom of the image,
+  // followed by those from the top of the image up to the current row,
+  // limiting each to the region exposed.
+
+  if (!m_WaterfallImage.isNull())
+  {
+    auto const dpr    = m_WaterfallImage.devicePixelRatio();
+    auto const width  = m_WaterfallImage.width();
+    auto const height = m_WaterfallImage.height();
+    auto const region = QRectF(event->rect());
+
+    auto const blit = [&](qreal const y,
+                          int   const row,
+                          int   const rows)
+    {
+      auto const target = QRectF(0, y, width / dpr, rows / dpr) & region;
+
+      if (target.isEmpty()) return;
+
+      p.drawImage(target, m_WaterfallImage, QRectF(target.x()              * dpr,
+                                                   row + (target.y() - y) * dpr,
+                                                   target.width()          * dpr,
+                                                   target.height()         * dpr));
+    };
+
+    blit(30,                          m_row, height - m_row);
+    blit(30 + (height - m_row) / dpr, 0,     m_row);
+  }
+
   p.drawPixmap(0, m_h1, m_SpectrumPixmap);
 
   p.drawPixmap(xFromFreq(m_freq), 30, m_DialPixmap[0]);
@@ -167,21 +196,22 @@ CPlotter::resizeEvent(QResizeEvent *)
 void
 CPlotter::drawLine(QString const & text)
 {
-  m_WaterfallPixmap.scroll(0, 1, m_WaterfallPixmap.rect());
+  if (m_WaterfallImage.isNull()) return;
 
-  QPainter p(&m_WaterfallPixmap);
+  scroll();
 
   // Draw a green line across the complete span.
 
-  p.setPen(Qt::green);
-  p.drawLine(0, 0, m_w, 0);
+  auto const line = reinterpret_cast<QRgb *>(m_WaterfallImage.scanLine(m_row));
+
+  std::fill(line, line + m_WaterfallImage.width(), QColor(Qt::green).rgb());
 
   // Compute the number of lines required before we need to draw the
   // text, and note the text to draw, saving it against a potential
   // replot request.
 
   m_text = text;
-  m_line = p.fontMetrics().height() * devicePixelRatio();
+  m_line = QFontMetrics(QFont()).height() * devicePixelRatio();
   m_replot.push_front(m_text);
 
   update();
@@ -191,7 +221,9 @@ void
 CPlotter::drawData(WF::SWide       swide,
                    WF::State const state)
 {
-  m_WaterfallPixmap.scroll(0, 1, m_WaterfallPixmap.rect());
+  if (m_WaterfallImage.isNull()) return;
+
+  scroll();
 
   // Flattening, we just process the visible width; tends to be the best
   // approach in terms of what happens when resizing to a larger size.
@@ -200,13 +232,7 @@ CPlotter::drawData(WF::SWide       swide,
 
   // Display the data in the waterfall, drawing only the displayed range.
 
-  QPainter p(&m_WaterfallPixmap);
-  
-  for (auto x = 0; x < m_w; ++x)
-  {
-    p.setPen(m_colors[m_scaler1D(swide[x])]);
-    p.drawPoint(x, 0);
-  }
+  drawRow(m_row, swide);
 
   // See if we've reached the point where we should draw previously computed
   // line text.
@@ -215,8 +241,11 @@ CPlotter::drawData(WF::SWide       swide,
   {
     m_line = std::numeric_limits<int>::max();
 
-    p.setPen(Qt::white);
-    p.drawText(5, p.fontMetrics().ascent(), m_text);
+    paintWaterfall([&text = std::as_const(m_text)](QPainter & p)
+    {
+      p.setPen(Qt::white);
+      p.drawText(5, p.fontMetrics().ascent(), text);
+    });
   }
 
   // A number of factors determine whether or not we should draw the spectrum.
@@ -292,7 +321,7 @@ CPlotter::drawData(WF::SWide       swide,
       case Spectrum::Cumulative:
       {
         p.setPen(Qt::cyan);
-        addPoints(std::begin(specData.savg), [](auto const value)
+        addPoints(m_savg.begin(), [](auto const value)
         {
           return 30.0f + 10.0f * std::log10(value);
         });
@@ -305,7 +334,7 @@ CPlotter::drawData(WF::SWide       swide,
       case Spectrum::LinearAvg:
       {
         p.setPen(Qt::yellow);
-        addPoints(std::begin(specData.slin), [](auto const value)
+        addPoints(m_slin.begin(), [](auto const value)
         {
           return value;
         });
@@ -347,12 +376,13 @@ CPlotter::drawDecodeLine(QColor const & color,
   auto const x1 = xFromFreq(ia);
   auto const x2 = xFromFreq(ib);
 
-  QPainter p(&m_WaterfallPixmap);
-  
-  p.setPen(color);
-  p.drawLine(qMin(x1, x2), 4, qMax(x1, x2), 4);
-  p.drawLine(qMin(x1, x2), 0, qMin(x1, x2), 9);
-  p.drawLine(qMax(x1, x2), 0, qMax(x1, x2), 9);
+  paintWaterfall([&color, x1, x2](QPainter & p)
+  {
+    p.setPen(color);
+    p.drawLine(qMin(x1, x2), 4, qMax(x1, x2), 4);
+    p.drawLine(qMin(x1, x2), 0, qMin(x1, x2), 9);
+    p.drawLine(qMax(x1, x2), 0, qMax(x1, x2), 9);
+  });
 }
 
 void
@@ -360,10 +390,11 @@ CPlotter::drawHorizontalLine(QColor const & color,
                              int    const   x,
                              int    const   width)
 {
-  QPainter p(&m_WaterfallPixmap);
-
-  p.setPen(color);
-  p.drawLine(x, 0, width <= 0 ? m_w : x + width, 0);
+  paintWaterfall([&color, x, end = width <= 0 ? m_w : x + width](QPainter & p)
+  {
+    p.setPen(color);
+    p.drawLine(x, 0, end, 0);
+  });
 }
 
 void
@@ -598,43 +629,88 @@ CPlotter::drawDials()
   }
 }
 
-// Replot the waterfall display, using the data present in the replot
-// buffer, if any.
+// Advance the waterfall ring by a row; the current row, which is then
+// the newest, is the one that was previously the oldest, and is to be
+// completely overwritten by the caller. Nothing is moved in the process.
 
 void
-CPlotter::replot()
+CPlotter::scroll()
+{
+  m_row = (m_row ? m_row : m_WaterfallImage.height()) - 1;
+}
+
+// Write waterfall data to a row of the waterfall image. Each device pixel
+// in the row takes its value from the logical pixel it's part of, which
+// the 1D scaler maps to an index into the palette, such that we write the
+// pixel values directly, with no painter involved.
+
+void
+CPlotter::drawRow(int       const   row,
+                  WF::SWide const & swide)
+{
+  auto const line  = reinterpret_cast<QRgb *>(m_WaterfallImage.scanLine(row));
+  auto const width = m_WaterfallImage.width();
+  auto const last  = std::min(m_w, static_cast<int>(swide.size())) - 1;
+  auto const scale = static_cast<float>(m_w) / width;
+
+  if (last < 0) return;
+
+  for (auto x = 0; x < width; ++x)
+  {
+    line[x] = m_palette[m_scaler1D(swide[std::min(static_cast<int>(x * scale), last)])];
+  }
+}
+
+// Paint on the waterfall image, with the painter set up such that the
+// logical coordinate system is that of the display, i.e., the newest row
+// is at the top. Should what's painted span the point at which the ring
+// wraps, we must paint twice, once on either side of it; the image bounds
+// clip anything that's not on the side being painted.
+
+template <typename Paint>
+void
+CPlotter::paintWaterfall(Paint && paint)
 {
-  if (m_WaterfallPixmap.isNull()) return;
+  if (m_WaterfallImage.isNull()) return;
+
+  auto const dpr = m_WaterfallImage.devicePixelRatio();
 
-  // Whack anything currently in the waterfall pixmap; we must do this
-  // before attaching a painter.
+  QPainter p(&m_WaterfallImage);
+
+  for (auto const offset : {m_row, m_row - m_WaterfallImage.height()})
+  {
+    p.save();
+    p.translate(0, offset / dpr);
+    paint(p);
+    p.restore();
+  }
+}
 
-  m_WaterfallPixmap.fill(Qt::black);
+// Replot the waterfall display, using the data present in the replot
+// buffer, if any.
 
-  // We need to consider that entries have been added to the replot
-  // buffer at a rate proportional to the display pixel ratio, i.e.,
-  // it deals in device pixels, not logical pixels, so we must deal
-  // with scaling in the y dimension for this to work out.
+void
+CPlotter::replot()
+{
+  if (m_WaterfallImage.isNull()) return;
 
-  QPainter p(&m_WaterfallPixmap);
+  // Whack anything currently in the waterfall image, and start the ring
+  // over, such that the newest row is the first one in the image.
 
-  p.scale(1, 1 / m_WaterfallPixmap.devicePixelRatio());
+  m_WaterfallImage.fill(Qt::black);
+  m_row = 0;
 
   // Our draw routine pushed entries to the front of the buffer, so we
-  // can iterate in forward order here, the Qt coordinate system having
-  // (0, 0) as the upper-left point.
+  // can iterate in forward order here, each entry being a row of the
+  // image. Entries have been added at a rate proportional to the device
+  // pixel ratio, i.e., they're in device pixels, not logical pixels; text
+  // is drawn using a painter, so we must account for that there.
 
   auto y = 0;
 
   for (auto && v : m_replot)
   {
-    std::visit([ratio   = m_WaterfallPixmap.devicePixelRatio(),
-                width   = m_WaterfallPixmap.size().width(),
-                extra   = p.fontMetrics().descent(),
-                &y      = std::as_const(y),
-                &colors = std::as_const(m_colors),
-                &scaler = std::as_const(m_scaler1D),
-                &p](auto const & v)
+    std::visit([this, y](auto const & v)
     {
       // Note that a monostate is constructed as the default when we
       // resize but have no backing data. There is nothing to in that
@@ -643,38 +719,33 @@ CPlotter::replot()
       using T = std::decay_t<decltype(v)>;
 
       // Line drawing; draw the usual green line across the width of the
-      // pixmap, annotated by the text provided.
+      // image, annotated by the text provided.
 
       if constexpr (std::is_same_v<T, QString>)
       {
+        auto const line = reinterpret_cast<QRgb *>(m_WaterfallImage.scanLine(y));
+
+        std::fill(line, line + m_WaterfallImage.width(), QColor(Qt::green).rgb());
+
+        QPainter p(&m_WaterfallImage);
+
         p.setPen(Qt::white);
-        p.save();
-        p.scale(1, ratio);
-        p.drawText(5, y / ratio - extra, v);
-        p.restore();
-        p.setPen(Qt::green);
-        p.drawLine(0, y, width, y);
+        p.drawText(5, y / m_WaterfallImage.devicePixelRatio() - p.fontMetrics().descent(), v);
       }
 
-      // Standard waterfall data display; run through the vector of data
-      // and color each corresponding point in the pixmap appropriately.
+      // Standard waterfall data display; color each corresponding point
+      // in the row appropriately.
 
       else if constexpr (std::is_same_v<T, WF::SWide>)
       {
-        auto const end = std::min(width, static_cast<int>(v.size()));
-          
-        for (auto x = 0; x < end; ++x)
-        {
-          p.setPen(colors[scaler(v[x])]);
-          p.drawPoint(x, y);
-        }
+        drawRow(y, v);
       }
     }, v);
 
     y++;
   }
 
-  // The waterfall pixmap should now look as it did before, but with the
+  // The waterfall image should now look as it did before, but with the
   // current zero, gain, and color palette applied; schedule a repaint.
 
   update();
@@ -703,23 +774,31 @@ CPlotter::resize()
     m_h2 = m_percent2D * (size().height() - 30) / 100.0;
     m_h1 =                size().height() - m_h2;
 
-    // We want our 3 main pixmaps sized to occupy our entire height,
-    // and to be completely filled with an opaque color, since we're
-    // going to take the opaque paint even optimization path. If this
-    // is a high-DPI display, scale the pixmaps to avoid text looking
+    // We want our main pixmaps and the waterfall image sized to occupy
+    // our entire height, and to be completely filled with an opaque color,
+    // since we're going to take the opaque paint even optimization path.
+    // If this is a high-DPI display, scale them to avoid text looking
     // pixelated.
 
     m_ScalePixmap     = makePixmap({m_w,   30}, Qt::white);
-    m_WaterfallPixmap = makePixmap({m_w, m_h1}, Qt::black);
     m_OverlayPixmap   = makePixmap({m_w, m_h2}, Qt::black);
 
+    // The waterfall is an image rather than a pixmap, since we write
+    // rows of it directly, and it's treated as a ring of rows rather
+    // than being scrolled; the ring starts over when we replot.
+
+    m_WaterfallImage = QImage(QSize(m_w, m_h1) * devicePixelRatio(), QImage::Format_RGB32);
+    m_WaterfallImage.setDevicePixelRatio(devicePixelRatio());
+    m_WaterfallImage.fill(Qt::black);
+    m_row = 0;
+
     // The replot circular buffer should have capacity to hold the full
-    // height of the waterfall pixmap, in device, not logical, pixels.
+    // height of the waterfall image, in device, not logical, pixels.
     // Since our variant lists std::monostate as the first alternative,
     // if we get larger here, the added items will be constructed using
     // std::monostate as the alternative.
 
-    m_replot.resize(m_WaterfallPixmap.size().height());
+    m_replot.resize(m_WaterfallImage.height());
 
     // Ensure the 2D scaler is working with the current spectrum height.
 
@@ -824,6 +903,19 @@ CPlotter::mouseReleaseEvent(QMouseEvent * event)
   }
 }
 
+// Average spectra, as drawn by the cumulative and linear average spectrum
+// displays; the linear average isn't recomputed with every spectrum, so
+// it's provided only when it has been.
+
+void
+CPlotter::setAverages(WF::SPlot const & savg,
+                      WF::SPlot const * slin)
+{
+  m_savg = savg;
+
+  if (slin) m_slin = *slin;
+}
+
 void
 CPlotter::setBinsPerPixel(int const binsPerPixel)
 {
@@ -845,6 +937,14 @@ CPlotter::setColors(Colors const & colors)
   if (m_colors != colors)
   {
     m_colors = colors;
+
+    for (std::size_t i = 0; i < m_palette.size(); ++i)
+    {
+      m_palette[i] = i < static_cast<std::size_t>(m_colors.size())
+                   ? m_colors[i].rgb()
+                   : qRgb(0, 0, 0);
+    }
+
     replot();
   }
 }
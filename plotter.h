@@ -14,6 +14,7 @@
 #include <limits>
 #include <variant>
 #include <QColor>
+#include <QImage>
 #include <QPixmap>
 #include <QPolygonF>
 #include <QSize>
@@ -157,6 +158,7 @@ public:
   void drawData(WF::SWide, WF::State);
   void drawDecodeLine    (const QColor &, int, int);
   void drawHorizontalLine(const QColor &, int, int);
+  void setAverages(WF::SPlot const &, WF::SPlot const *);
   void setBinsPerPixel(int);
   void setColors(Colors const &);
   void setDialFreq(float);
@@ -199,6 +201,11 @@ private:
     WF::SWide
   >>;
 
+  // Waterfall colors, as pixel values, indexed by the value that the
+  // 1D scaler returns.
+
+  using Palette = std::array<QRgb, 256>;
+
   // Accessors
 
   bool  shouldDrawSpectrum(WF::State) const;
@@ -211,8 +218,13 @@ private:
   void drawMetrics();
   void drawFilter();
   void drawDials();
+  void drawRow(int, WF::SWide const &);
   void replot();
   void resize();
+  void scroll();
+
+  template <typename Paint>
+  void paintWaterfall(Paint &&);
 
   // Data members ** ORDER DEPENDENCY **
 
@@ -226,6 +238,7 @@ private:
   int    m_waterfallAvg  =  1;
   int    m_lastMouseX    = -1;
   int    m_line          =  std::numeric_limits<int>::max();
+  int    m_row           =  0;
   int    m_startFreq     =  0;
   int    m_freq          =  0;
   int    m_w             =  0;
@@ -238,7 +251,10 @@ private:
   Scaler1D  m_scaler1D;
   Scaler2D  m_scaler2D;
   Colors    m_colors;
+  Palette   m_palette = {};
   Replot    m_replot;
+  WF::SPlot m_savg = {};
+  WF::SPlot m_slin = {};
   QPolygonF m_points;
   Flatten   m_flatten;
   Spectrum  m_spectrum = Spectrum::Current;
@@ -246,7 +262,7 @@ private:
   QTimer  * m_resizeTimer;
 
   QPixmap m_ScalePixmap;
-  QPixmap m_WaterfallPixmap;
+  QImage  m_WaterfallImage;
   QPixmap m_OverlayPixmap;
   QPixmap m_SpectrumPixmap;
   
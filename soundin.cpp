@@ -53,7 +53,7 @@ void SoundInput::start(QAudioDevice const& device, int framesPerBuffer, AudioDev
 //  qDebug () << "Preferred audio input format:" << format;
   format.setSampleFormat (QAudioFormat::Int16);
   format.setChannelCount (AudioDevice::Mono == channel ? 1 : 2);
-  format.setSampleRate (48000);
+  format.setSampleRate (sink->selectSampleRate (format.sampleRate ()));
   if (!format.isValid ())
     {
       Q_EMIT error (tr ("Requested input audio format is not valid."));
@@ -76,7 +76,10 @@ void SoundInput::start(QAudioDevice const& device, int framesPerBuffer, AudioDev
 
   connect (m_stream.data(), &QAudioSource::stateChanged, this, &SoundInput::handleStateChanged);
 
-  m_stream->setBufferSize (m_stream->format ().bytesForFrames (framesPerBuffer));
+  // Buffer size is expressed in terms of 48kHz frames; scale it to keep
+  // the same duration at whatever rate we ended up with.
+
+  m_stream->setBufferSize (m_stream->format ().bytesForFrames (static_cast<qint32> (static_cast<qint64> (framesPerBuffer) * format.sampleRate () / 48000)));
   if (sink->initialize (QIODevice::WriteOnly, channel))
     {
       m_stream->start (sink);
@@ -0,0 +1,66 @@
+#ifndef __JS8_TESTING
+#define __JS8_TESTING
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Access to the internals of the decoder, for the tests only; present in
+// JS8.cpp only when it's compiled with JS8_TESTING defined, which is done
+// only for the test targets.
+
+namespace JS8::Testing
+{
+    // Taps of the low pass filter used during signal subtraction, at delays
+    // 0 through NFILT.
+
+    std::vector<std::complex<float>> subtractionTaps();
+
+    // Result of subtracting a signal; the samples remaining, NMAX of them for
+    // the submode, and the reference signal generated for the subtraction.
+
+    struct Subtraction
+    {
+        std::vector<float>               residual;
+        std::vector<std::complex<float>> reference;
+    };
+
+    // Subtract a signal having the tones provided, at the frequency and with
+    // the DT provided, from the samples provided, as the decoder would once
+    // it had decoded the signal.
+
+    Subtraction subtract(int                  submode,
+                         std::int16_t const * samples,
+                         int                  size,
+                         int          const * tones,
+                         float                frequency,
+                         float                dt);
+
+    // A candidate selected from the results of the sync search.
+
+    struct Candidate
+    {
+        float freq;
+        float step;
+        float sync;
+    };
+
+    // Minimum normalized sync of a candidate, and the most candidates that
+    // will be selected.
+
+    float       syncThreshold();
+    std::size_t maxCandidates();
+
+    // Select candidates from the results of a sync search, one entry for
+    // each frequency bin, in frequency order, as the decoder would, where
+    // near-duplicates are those within `az` Hz of one another. As in the
+    // decoder, the buffer holding the results is retained across calls.
+
+    std::vector<Candidate> candidates(std::vector<float> const & freq,
+                                      std::vector<float> const & step,
+                                      std::vector<float> const & sync,
+                                      float                      az);
+}
+
+#endif
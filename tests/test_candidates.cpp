@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/key.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ranked_index.hpp>
+#include "JS8Testing.hpp"
+
+// Checks candidate selection from the results of the sync search against
+// the multi_index container selection it replaced, on random results, and
+// times both. Sync values are quantized, so that there are plenty of ties.
+// Exactly equal values are taken in frequency order; the old container
+// ordered them as its trees happened to be relinked during normalization,
+// so here it's given a key that orders them by frequency, the rule that the
+// current selection documents, and the two lists must then be identical.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  constexpr int TRIALS = 2000;
+
+  // Bin spacing and near-duplicate range of the normal, fast, turbo, slow,
+  // and ultra submodes, in that order.
+
+  struct Spacing
+  {
+    float df;
+    float az;
+  };
+
+  constexpr Spacing SPACINGS[]
+  {
+    {12000.0f / 3840, (12000.0f / 1920) * 0.64f},
+    {12000.0f / 2400, (12000.0f / 1200) * 0.8f},
+    {12000.0f / 1200, (12000.0f /  600) * 0.6f},
+    {12000.0f / 7680, (12000.0f / 3840) * 0.64f},
+    {12000.0f /  768, (12000.0f /  384) * 0.64f}
+  };
+
+  using Candidates = std::vector<JS8::Testing::Candidate>;
+
+  // Selection as it was, by way of a container indexing sync results by
+  // frequency, by rank, and by descending sync.
+
+  namespace Legacy
+  {
+    struct Sync
+    {
+      float freq;
+      float step;
+      float sync;
+    };
+
+    namespace Tag
+    {
+      struct Freq {};
+      struct Rank {};
+      struct Sync {};
+    }
+
+    namespace MI    = boost::multi_index;
+    using SyncIndex = MI::multi_index_container
+    <
+      Sync,
+      MI::indexed_by
+      <
+        MI::ordered_non_unique<
+          MI::tag<Tag::Freq>,
+          MI::key<&Sync::freq>
+        >,
+        MI::ranked_non_unique<
+          MI::tag<Tag::Rank>,
+          MI::key<&Sync::sync>
+        >,
+        MI::ordered_non_unique<
+          MI::tag<Tag::Sync>,
+          MI::key<&Sync::sync, &Sync::freq>,
+          MI::composite_key_compare<std::greater<float>, std::less<float>>
+        >
+      >
+    >;
+
+    Candidates
+    candidates(std::vector<float> const & freq,
+               std::vector<float> const & step,
+               std::vector<float> const & sync,
+               float              const   az)
+    {
+      SyncIndex index;
+
+      for (std::size_t i = 0; i < freq.size(); ++i) index.insert({freq[i], step[i], sync[i]});
+
+      if (index.empty()) return {};
+
+      auto & freqIndex = index.get<Tag::Freq>();
+      auto & rankIndex = index.get<Tag::Rank>();
+      auto & syncIndex = index.get<Tag::Sync>();
+
+      auto const normalize =
+      [
+        sync = rankIndex.nth(rankIndex.size() * 4 / 10)->sync
+      ]
+      (Sync & entry)
+      {
+        entry.sync /= sync;
+      };
+
+      for (auto it = freqIndex.begin(); it != freqIndex.end(); ++it) freqIndex.modify(it, normalize);
+
+      Candidates candidates;
+
+      for (auto it  = syncIndex.begin();
+                it != syncIndex.end() && candidates.size() < JS8::Testing::maxCandidates();
+                it  = syncIndex.begin())
+      {
+        if (it->sync < JS8::Testing::syncThreshold() || std::isnan(it->sync)) break;
+
+        candidates.push_back({it->freq, it->step, it->sync});
+
+        freqIndex.erase(freqIndex.lower_bound(it->freq - az),
+                        freqIndex.upper_bound(it->freq + az));
+      }
+
+      return candidates;
+    }
+  }
+
+  bool
+  identical(Candidates const & a,
+            Candidates const & b)
+  {
+    return std::equal(a.begin(), a.end(),
+                      b.begin(), b.end(),
+                      [](auto const & x,
+                         auto const & y)
+                      {
+                        return x.freq == y.freq &&
+                               x.step == y.step &&
+                               x.sync == y.sync;
+                      });
+  }
+
+  // Random sync results for a search of `n` bins. Most trials have a few
+  // strong bins among many weak ones; some have strong bins throughout, so
+  // that the limit on the number of candidates is reached.
+
+  void
+  generate(std::mt19937       & random,
+           Spacing      const & spacing,
+           std::size_t  const   n,
+           bool         const   crowded,
+           std::vector<float> & freq,
+           std::vector<float> & step,
+           std::vector<float> & sync)
+  {
+    std::exponential_distribution<float>  exponential(crowded ? 0.25f : 1.0f);
+    std::uniform_int_distribution<int>    steps(-20, 60);
+    std::uniform_int_distribution<int>    start(0, 50);
+
+    auto const i0 = start(random);
+
+    freq.clear();
+    step.clear();
+    sync.clear();
+
+    for (std::size_t k = 0; k < n; ++k)
+    {
+      freq.push_back(spacing.df * (i0 + k));
+      step.push_back(0.04f * steps(random));
+      sync.push_back(std::round((1.0f + exponential(random)) * 16.0f) / 16.0f);
+    }
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main()
+{
+  using Clock = std::chrono::steady_clock;
+
+  std::mt19937                          random(1);
+  std::uniform_int_distribution<int>    sizes(100, 1500);
+  std::vector<float>                    freq;
+  std::vector<float>                    step;
+  std::vector<float>                    sync;
+  Clock::duration                       legacy   = {};
+  Clock::duration                       current  = {};
+  int                                   failures = 0;
+  std::size_t                           selected = 0;
+
+  for (int trial = 0; trial < TRIALS; ++trial)
+  {
+    auto const & spacing = SPACINGS[trial % std::size(SPACINGS)];
+
+    generate(random, spacing, sizes(random), trial % 4 == 3, freq, step, sync);
+
+    auto const start    = Clock::now();
+    auto const expected = Legacy::candidates(freq, step, sync, spacing.az);
+    auto const middle   = Clock::now();
+    auto const actual   = JS8::Testing::candidates(freq, step, sync, spacing.az);
+    auto const end      = Clock::now();
+
+    legacy   += middle - start;
+    current  += end    - middle;
+    selected += actual.size();
+
+    if (!identical(actual, expected))
+    {
+      std::cout << "trial " << trial << ": "
+                << actual.size() << " candidates, expected "
+                << expected.size() << std::endl;
+      ++failures;
+    }
+  }
+
+  auto const us = [](Clock::duration const duration)
+  {
+    return std::chrono::duration<double, std::micro>(duration).count() / TRIALS;
+  };
+
+  std::cout << TRIALS   << " trials, "
+            << selected << " candidates, "
+            << failures << " mismatched; "
+            << "multi_index " << us(legacy)  << "us, "
+            << "current "     << us(current) << "us per selection"
+            << std::endl;
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,505 @@
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <QMap>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include "varicode.h"
+
+// The callsign, grid, and escape recognizers in varicode.cpp replaced the
+// regular expressions used by the functions below; checks each function
+// against the function it was before, i.e., as kept here, on random and on
+// structured input, reporting any difference. Where a function was only
+// changed in part, e.g., in packing heartbeats, only the part that changed
+// is kept here, and the rest is done through Varicode.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  constexpr int ITERATIONS = 200000;  // Per function
+
+  namespace Regex
+  {
+    QString const grid_pattern              = R"((?<grid>[A-X]{2}[0-9]{2}(?:[A-X]{2}(?:[0-9]{2})?)*)+)";
+    QString const base_callsign_pattern     = R"((?<callsign>\b(?<base>([0-9A-Z])?([0-9A-Z])([0-9])([A-Z])?([A-Z])?([A-Z])?)(?<portable>[/][P])?\b))";
+    QString const compound_callsign_pattern = R"((?<callsign>(?:[@]?|\b)(?<extended>[A-Z0-9\/@][A-Z0-9\/]{0,2}[\/]?[A-Z0-9\/]{0,3}[\/]?[A-Z0-9\/]{0,3})\b))";
+    QString const pack_callsign_pattern     = R"(([0-9A-Z ])([0-9A-Z])([0-9])([A-Z ])([A-Z ])([A-Z ]))";
+    QString const heartbeat_pattern         = R"(^\s*(?<callsign>[@](?:ALLCALL|HB)\s+)?(?<type>CQ CQ CQ|CQ DX|CQ QRP|CQ CONTEST|CQ FIELD|CQ FD|CQ CQ|CQ|HB|HEARTBEAT(?!\s+SNR))(?:\s(?<grid>[A-R]{2}[0-9]{2}))?\b)";
+
+    bool
+    isValidCompoundCallsign(QStringView const callsign)
+    {
+      auto const & basecalls = Varicode::basecallTable();
+
+      if (callsign.length() - callsign.count('/') > 9) return false;
+
+      if (auto const index = callsign.indexOf('/'); index != -1)
+      {
+        return !basecalls.contains(callsign.first(index).toString());
+      }
+
+      if (callsign.startsWith('@')) return true;
+
+      return callsign.length() > 2 && QRegularExpression("[0-9][A-Z]|[A-Z][0-9]").match(callsign.toString()).hasMatch();
+    }
+
+    bool
+    isValidCallsign(QString const & callsign,
+                    bool          * pIsCompound)
+    {
+      if (Varicode::basecallTable().contains(callsign))
+      {
+        if (pIsCompound) *pIsCompound = false;
+        return true;
+      }
+
+      auto match = QRegularExpression(base_callsign_pattern).match(callsign);
+
+      if (match.hasMatch() && match.capturedLength() == callsign.length())
+      {
+        if (pIsCompound) *pIsCompound = false;
+        return callsign.length() > 2 && QRegularExpression("[0-9][A-Z]|[A-Z][0-9]").match(callsign).hasMatch();
+      }
+
+      match = QRegularExpression("^" + compound_callsign_pattern).match(callsign);
+
+      if (match.hasMatch() && match.capturedLength() == callsign.length())
+      {
+        bool const isValid = isValidCompoundCallsign(match.capturedView(0));
+
+        if (pIsCompound) *pIsCompound = isValid;
+        return isValid;
+      }
+
+      if (pIsCompound) *pIsCompound = false;
+      return false;
+    }
+
+    bool
+    isCompoundCallsign(QString const & callsign)
+    {
+      if (Varicode::basecallTable().contains(callsign) && !callsign.startsWith("@")) return false;
+
+      auto match = QRegularExpression(base_callsign_pattern).match(callsign);
+
+      if (match.hasMatch() && match.capturedLength() == callsign.length()) return false;
+
+      match = QRegularExpression("^" + compound_callsign_pattern).match(callsign);
+
+      if (!match.hasMatch() || match.capturedLength() != callsign.length()) return false;
+
+      return isValidCompoundCallsign(match.capturedView(0));
+    }
+
+    QStringList
+    parseCallsigns(QString const & input)
+    {
+      QStringList callsigns;
+
+      for (auto iter = QRegularExpression(compound_callsign_pattern).globalMatch(input); iter.hasNext();)
+      {
+        auto const match = iter.next();
+
+        if (!match.hasMatch()) continue;
+
+        auto const callsign = match.captured("callsign").trimmed();
+
+        if (!isValidCallsign(callsign, nullptr)) continue;
+
+        if (QRegularExpression(grid_pattern).match(callsign).hasMatch()) continue;
+
+        callsigns.append(callsign);
+      }
+
+      return callsigns;
+    }
+
+    QStringList
+    parseGrids(QString const & input)
+    {
+      QStringList grids;
+
+      for (auto iter = QRegularExpression(grid_pattern).globalMatch(input); iter.hasNext();)
+      {
+        auto const match = iter.next();
+
+        if (!match.hasMatch()) continue;
+
+        auto const grid = match.captured("grid");
+
+        if (grid == "RR73") continue;
+
+        grids.append(grid);
+      }
+
+      return grids;
+    }
+
+    quint32
+    packCallsign(QString const & value,
+                 bool          * pPortable)
+    {
+      auto const & alphanumeric = Varicode::alphanumericTable();
+      auto const & basecalls    = Varicode::basecallTable();
+      quint32      packed       = 0;
+      QString      callsign     = value.toUpper().trimmed();
+
+      if (basecalls.contains(callsign)) return basecalls.value(callsign);
+
+      if (callsign.endsWith("/P"))
+      {
+        callsign = callsign.left(callsign.length() - 2);
+
+        if (pPortable) *pPortable = true;
+      }
+
+      if (callsign.startsWith("3DA0"))
+      {
+        callsign = "3D0" + callsign.mid(4);
+      }
+
+      if (callsign.startsWith("3X") && 'A' <= callsign.at(2) && callsign.at(2) <= 'Z')
+      {
+        callsign = "Q" + callsign.mid(2);
+      }
+
+      auto const slen = callsign.length();
+
+      if (slen < 2 || slen > 6) return packed;
+
+      QStringList permutations = {callsign};
+
+      if (slen == 2)
+      {
+        permutations.append(" " + callsign + "   ");
+      }
+      if (slen == 3)
+      {
+        permutations.append(" " + callsign + "  ");
+        permutations.append(callsign + "   ");
+      }
+      if (slen == 4)
+      {
+        permutations.append(" " + callsign + " ");
+        permutations.append(callsign + "  ");
+      }
+      if (slen == 5)
+      {
+        permutations.append(" " + callsign);
+        permutations.append(callsign + " ");
+      }
+
+      QString            matched;
+      QRegularExpression m(pack_callsign_pattern);
+
+      for (auto const & permutation : permutations)
+      {
+        if (auto const match = m.match(permutation); match.hasMatch()) matched = match.captured(0);
+      }
+
+      if (matched.length() < 6) return packed;
+
+      packed = alphanumeric.indexOf(matched.at(0));
+      packed = 36 * packed + alphanumeric.indexOf(matched.at(1));
+      packed = 10 * packed + alphanumeric.indexOf(matched.at(2));
+      packed = 27 * packed + alphanumeric.indexOf(matched.at(3)) - 10;
+      packed = 27 * packed + alphanumeric.indexOf(matched.at(4)) - 10;
+      packed = 27 * packed + alphanumeric.indexOf(matched.at(5)) - 10;
+
+      return packed;
+    }
+
+    quint32
+    packAlphaNumeric22(QString const & value,
+                       bool    const   isFlag)
+    {
+      auto const & alphanumeric = Varicode::alphanumericTable();
+      QString      word         = QString(value).replace(QRegularExpression("[^A-Z0-9/ ]"), "");
+
+      if (word.length() < 4) word = word + QString(" ").repeated(4 - word.length());
+
+      quint32 const a = 38 * 38 * 38 * alphanumeric.indexOf(word.at(0));
+      quint32 const b = 38 * 38 * alphanumeric.indexOf(word.at(1));
+      quint32 const c = 38 * alphanumeric.indexOf(word.at(2));
+      quint32 const d = alphanumeric.indexOf(word.at(3));
+
+      return ((a + b + c + d) << 1) + static_cast<int>(isFlag);
+    }
+
+    quint64
+    packAlphaNumeric50(QString const & value)
+    {
+      auto const & alphanumeric = Varicode::alphanumericTable();
+      QString      word         = QString(value).replace(QRegularExpression("[^A-Z0-9 /@]"), "");
+
+      if (word.length() > 3 && word.at(3) != '/') word.insert(3, ' ');
+      if (word.length() > 7 && word.at(7) != '/') word.insert(7, ' ');
+
+      if (word.length() < 11) word = word + QString(" ").repeated(11 - word.length());
+
+      quint64 const a = (quint64)38 * 38 * 38 * 2 * 38 * 38 * 38 * 2 * 38 * 38 * alphanumeric.indexOf(word.at(0));
+      quint64 const b = (quint64)38 * 38 * 38 * 2 * 38 * 38 * 38 * 2 * 38 * alphanumeric.indexOf(word.at(1));
+      quint64 const c = (quint64)38 * 38 * 38 * 2 * 38 * 38 * 38 * 2 * alphanumeric.indexOf(word.at(2));
+      quint64 const d = (quint64)38 * 38 * 38 * 2 * 38 * 38 * 38 * (int)(word.at(3) == '/');
+      quint64 const e = (quint64)38 * 38 * 38 * 2 * 38 * 38 * alphanumeric.indexOf(word.at(4));
+      quint64 const f = (quint64)38 * 38 * 38 * 2 * 38 * alphanumeric.indexOf(word.at(5));
+      quint64 const g = (quint64)38 * 38 * 38 * 2 * alphanumeric.indexOf(word.at(6));
+      quint64 const h = (quint64)38 * 38 * 38 * (int)(word.at(7) == '/');
+      quint64 const i = (quint64)38 * 38 * alphanumeric.indexOf(word.at(8));
+      quint64 const j = (quint64)38 * alphanumeric.indexOf(word.at(9));
+      quint64 const k = (quint64)alphanumeric.indexOf(word.at(10));
+
+      return a + b + c + d + e + f + g + h + i + j + k;
+    }
+
+    QString
+    unescape(QString const & text)
+    {
+      QString unescaped(text);
+#if JS8_USE_ESCAPE_SUB_CHAR
+      static int const   size = 5;
+      QRegularExpression r("([\\x1A][0-9a-fA-F]{4})");
+#else
+      static int const   size = 6;
+      QRegularExpression r("(([uU][+]|\\\\[uU])[0-9a-fA-F]{4})");
+#endif
+      qsizetype               pos = 0;
+      QRegularExpressionMatch match;
+
+      while ((pos = unescaped.indexOf(r, pos, &match)) != -1)
+      {
+        unescaped.replace(pos++, size, QChar(match.captured(1).right(4).toUShort(nullptr, 16)));
+      }
+
+      return unescaped;
+    }
+
+    // The first number for which the table gives the type, or zero.
+
+    quint8
+    typeNumber(QString (* const table)(int),
+               QString   const & type)
+    {
+      for (int i = 0; i < 8; ++i) if (table(i) == type) return i;
+
+      return 0;
+    }
+
+    QString
+    packHeartbeatMessage(QString const & text,
+                         QString const & callsign,
+                         int           * n)
+    {
+      auto const parsedText = QRegularExpression(heartbeat_pattern).match(text);
+
+      if (!parsedText.hasMatch() || callsign.isEmpty())
+      {
+        *n = 0;
+        return QString();
+      }
+
+      auto const extra = parsedText.captured("grid");
+      auto const type  = parsedText.captured("type");
+      auto const isAlt = type.startsWith("CQ");
+
+      quint16 packed_extra = (1 << 15) - 1;
+
+      if (extra.length() == 4 && QRegularExpression(grid_pattern).match(extra).hasMatch())
+      {
+        packed_extra = Varicode::packGrid(extra);
+      }
+
+      quint8 cqNumber = typeNumber(Varicode::hbString, type);
+
+      if (isAlt)
+      {
+        packed_extra |= (1 << 15);
+        cqNumber = typeNumber(Varicode::cqString, type);
+      }
+
+      auto const frame = Varicode::packCompoundFrame(callsign, Varicode::FrameHeartbeat, packed_extra, cqNumber);
+
+      *n = frame.isEmpty() ? 0 : parsedText.captured(0).length();
+
+      return frame;
+    }
+  }
+
+  // Inputs are either random strings of characters that matter to one or
+  // more of the grammars, or sequences of tokens that look like callsigns,
+  // grids, heartbeats, and escapes, or nearly so, with one character
+  // occasionally replaced by a random one.
+
+  constexpr std::u16string_view FUZZ_CHARS = u"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/@ abcfuU+\\_.-\x1Aé中";
+
+  constexpr std::array FUZZ_TOKENS
+  {
+    "K1ABC", "KN4CRD", "J1Y", "VE3", "3DA0RU", "3XA1B", "/P", "/", "@", "@ALLCALL",
+    "@GROUP/1", "@DX/NA", "<....>", "EM73", "EM73TU", "JO22MB12", "RR73", "AA00XX99",
+    "CQ ", "CQ DX ", "HB ", "HEARTBEAT ", "HEARTBEAT SNR ", "@HB ",
+    " ", "  ", "U+00E9", "u+0041", "\\u00C4", "\\U004g", "\x1A" "0041"
+  };
+
+  class Fuzz
+  {
+    std::mt19937 m_random;
+
+    std::size_t index(std::size_t const n) { return m_random() % n; }
+
+  public:
+
+    explicit Fuzz(std::uint32_t const seed)
+    : m_random(seed)
+    {}
+
+    QString
+    operator()()
+    {
+      QString input;
+
+      if (index(2))
+      {
+        for (std::size_t i = 0, n = index(17); i < n; ++i) input += QChar(FUZZ_CHARS[index(FUZZ_CHARS.size())]);
+      }
+      else
+      {
+        for (std::size_t i = 0, n = 1 + index(4); i < n; ++i) input += FUZZ_TOKENS[index(FUZZ_TOKENS.size())];
+
+        if (index(4) == 0) input[static_cast<qsizetype>(index(input.size()))] = QChar(FUZZ_CHARS[index(FUZZ_CHARS.size())]);
+      }
+
+      return input;
+    }
+  };
+
+  // Each function checked, with the results of the original and of the
+  // current version rendered as text, for comparison and for reporting.
+
+  struct Recognizer
+  {
+    char const                            * name;
+    std::function<QString(QString const &)> original;
+    std::function<QString(QString const &)> current;
+  };
+
+  QString
+  flag(bool const value)
+  {
+    return value ? "true" : "false";
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main()
+{
+  std::array const recognizers
+  {
+    Recognizer
+    {
+      "isValidCallsign",
+      [](QString const & input) { bool compound = false; auto const valid = Regex::isValidCallsign(input, &compound);    return flag(valid) + " " + flag(compound); },
+      [](QString const & input) { bool compound = false; auto const valid = Varicode::isValidCallsign(input, &compound); return flag(valid) + " " + flag(compound); }
+    },
+    Recognizer
+    {
+      "isCompoundCallsign",
+      [](QString const & input) { return flag(Regex::isCompoundCallsign(input));    },
+      [](QString const & input) { return flag(Varicode::isCompoundCallsign(input)); }
+    },
+    Recognizer
+    {
+      "parseCallsigns",
+      [](QString const & input) { return Regex::parseCallsigns(input)   .join('|'); },
+      [](QString const & input) { return Varicode::parseCallsigns(input).join('|'); }
+    },
+    Recognizer
+    {
+      "parseGrids",
+      [](QString const & input) { return Regex::parseGrids(input)   .join('|'); },
+      [](QString const & input) { return Varicode::parseGrids(input).join('|'); }
+    },
+    Recognizer
+    {
+      "packCallsign",
+      [](QString const & input) { bool portable = false; auto const packed = Regex::packCallsign(input, &portable);    return QString::number(packed) + " " + flag(portable); },
+      [](QString const & input) { bool portable = false; auto const packed = Varicode::packCallsign(input, &portable); return QString::number(packed) + " " + flag(portable); }
+    },
+    Recognizer
+    {
+      "packAlphaNumeric22",
+      [](QString const & input) { return QString::number(Regex::packAlphaNumeric22(input, true))    + " " + QString::number(Regex::packAlphaNumeric22(input, false));    },
+      [](QString const & input) { return QString::number(Varicode::packAlphaNumeric22(input, true)) + " " + QString::number(Varicode::packAlphaNumeric22(input, false)); }
+    },
+    Recognizer
+    {
+      "packAlphaNumeric50",
+      [](QString const & input) { return QString::number(Regex::packAlphaNumeric50(input));    },
+      [](QString const & input) { return QString::number(Varicode::packAlphaNumeric50(input)); }
+    },
+    Recognizer
+    {
+      "unescape",
+      [](QString const & input) { return Regex::unescape(input);    },
+      [](QString const & input) { return Varicode::unescape(input); }
+    },
+    Recognizer
+    {
+      "escape",
+      [](QString const & input) { return Regex::unescape(Varicode::escape(input));    },
+      [](QString const & input) { return Varicode::unescape(Varicode::escape(input)); }
+    },
+    Recognizer
+    {
+      "packHeartbeatMessage",
+      [](QString const & input) { int n = 0; auto const frame = Regex::packHeartbeatMessage(input, "KN4CRD", &n);    return frame + " " + QString::number(n); },
+      [](QString const & input) { int n = 0; auto const frame = Varicode::packHeartbeatMessage(input, "KN4CRD", &n); return frame + " " + QString::number(n); }
+    }
+  };
+
+  // Varicode logs as it goes, e.g., on every compound callsign check.
+
+  qInstallMessageHandler([](QtMsgType, QMessageLogContext const &, QString const &) {});
+
+  int status = 0;
+
+  for (auto const & recognizer : recognizers)
+  {
+    Fuzz fuzz(qHash(QString(recognizer.name)));
+    int  mismatches = 0;
+
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+      auto const input    = fuzz();
+      auto const original = recognizer.original(input);
+      auto const current  = recognizer.current (input);
+
+      if (original == current) continue;
+
+      if (++mismatches <= 5)
+      {
+        std::cout << recognizer.name                      << ": "
+                  << input   .toUtf8().constData()         << " -> "
+                  << current .toUtf8().constData()         << ", expected "
+                  << original.toUtf8().constData()         << std::endl;
+      }
+    }
+
+    std::cout << recognizer.name << ": " << mismatches << " mismatched" << std::endl;
+
+    if (mismatches) status = 1;
+  }
+
+  return status;
+}
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "commons.h"
+#include "FFTW.hpp"
+#include "JS8.hpp"
+#include "JS8Submode.hpp"
+#include "JS8Testing.hpp"
+#include "varicode.h"
+
+// Checks signal subtraction. The decoder filters the complex amplitude of
+// a signal by overlap-save, over the duration of the signal only, where
+// the Fortran version filtered it over the whole of the samples, by
+// circular convolution, zero outside of the signal. The two should
+// subtract the same from every sample, to within rounding; signals are
+// placed so as to be clipped at either end of the samples, as well as
+// wholly within them.
+
+/******************************************************************************/
+// Private Implementation
+/******************************************************************************/
+
+namespace
+{
+  constexpr double TAU       = 2 * M_PI;
+  constexpr double NOISE     = 100.0;
+  constexpr double AMPLITUDE = 300.0;
+  constexpr double TOLERANCE = 1e-4;
+  constexpr int    SIGNALS   = 8;    // Per submode
+
+  constexpr std::array SUBMODES
+  {
+    Varicode::JS8CallNormal,
+    Varicode::JS8CallFast,
+    Varicode::JS8CallTurbo,
+    Varicode::JS8CallSlow,
+    Varicode::JS8CallUltra
+  };
+
+  constexpr std::string_view ALPHABET = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?";
+
+  // A signal, in Gaussian noise, starting at the sample provided, which
+  // may be negative.
+
+  struct Case
+  {
+    std::vector<std::int16_t>        samples;
+    std::array<int, JS8_NUM_SYMBOLS> tones;
+    double                           frequency;
+    int                              start;
+  };
+
+  Case
+  synthesize(int            const   submode,
+             int            const   start,
+             std::mt19937         & random)
+  {
+    std::uniform_real_distribution<double> uniform;
+    std::normal_distribution<double>       gaussian;
+
+    int    const   nsps    = JS8::Submode::symbolSamples(submode);
+    double const   spacing = JS8::Submode::toneSpacing(submode);
+    auto   const & costas  = JS8::Costas::array(JS8::Submode::costas(submode));
+
+    Case        test;
+    std::string message(12, ' ');
+
+    for (auto & c : message) c = ALPHABET[random() % ALPHABET.size()];
+
+    JS8::encode(random() % 8, costas, message.c_str(), test.tones.data());
+
+    test.frequency = 500.0 + 2000.0 * uniform(random);
+    test.start     = start;
+
+    std::vector<double> wave(JS8::Submode::framesPerCycle(submode));
+
+    for (auto & sample : wave) sample = NOISE * gaussian(random);
+
+    double phi = TAU * uniform(random);
+
+    for (int j = 0; j < JS8_NUM_SYMBOLS * nsps; ++j)
+    {
+      phi = std::fmod(phi + TAU * (test.frequency + test.tones[j / nsps] * spacing) / JS8_RX_SAMPLE_RATE, TAU);
+
+      if (auto const i = start + j; i >= 0 && i < static_cast<int>(wave.size()))
+      {
+        wave[i] += AMPLITUDE * std::sin(phi);
+      }
+    }
+
+    test.samples.resize(wave.size());
+
+    std::transform(wave.begin(), wave.end(), test.samples.begin(), [](double const value)
+    {
+      return static_cast<std::int16_t>(std::clamp(std::round(value), -32768.0, 32767.0));
+    });
+
+    return test;
+  }
+
+  // Subtract the signal, and filter its amplitude as the Fortran version
+  // did; returns the largest difference between the two in the amount
+  // subtracted from any sample, relative to the largest amount subtracted
+  // from any sample.
+
+  double
+  check(int  const   submode,
+        Case const & test)
+  {
+    auto const dt     = static_cast<float>(test.start) / JS8_RX_SAMPLE_RATE;
+    auto const result = JS8::Testing::subtract(submode,
+                                               test.samples.data(),
+                                               static_cast<int>(test.samples.size()),
+                                               test.tones.data(),
+                                               static_cast<float>(test.frequency),
+                                               dt);
+
+    auto const & cref       = result.reference;
+    int  const   nmax       = static_cast<int>(result.residual.size());
+    auto const   nstart     = static_cast<int>(dt * 12000.0f);
+    auto const   cref_start = std::max(-nstart, 0);
+    auto const   dd_start   = std::max( nstart, 0);
+    auto const   length     = std::min(static_cast<int>(cref.size()) - cref_start, nmax - dd_start);
+
+    std::vector<float> original(nmax);
+
+    std::copy_n(test.samples.begin(), std::min(nmax, static_cast<int>(test.samples.size())), original.begin());
+
+    // Filter the complex amplitude over the whole of the samples, as a
+    // circular convolution, zero outside of the signal.
+
+    auto const taps = JS8::Testing::subtractionTaps();
+
+    std::vector<std::complex<float>> filter(nmax);
+    std::vector<std::complex<float>> cfilt (nmax);
+
+    std::copy(taps.begin(), taps.end(), filter.begin());
+
+    for (int i = 0; i < length; ++i)
+    {
+      cfilt[i] = original[dd_start + i] * std::conj(cref[cref_start + i]);
+    }
+
+    auto const forward  = FFTW::plan({FFTW::Kind::FORWARD,  nmax});
+    auto const backward = FFTW::plan({FFTW::Kind::BACKWARD, nmax});
+
+    forward.execute(filter.data());
+    forward.execute(cfilt.data());
+
+    for (int i = 0; i < nmax; ++i) cfilt[i] *= filter[i] * (1.0f / nmax);
+
+    backward.execute(cfilt.data());
+
+    double error = 0.0;
+    double scale = 0.0;
+
+    for (int i = 0; i < length; ++i)
+    {
+      double const expected = 2.0f * std::real(cfilt[i] * cref[cref_start + i]);
+      double const actual   = original[dd_start + i] - result.residual[dd_start + i];
+
+      error = std::max(error, std::abs(actual - expected));
+      scale = std::max(scale, std::abs(expected));
+    }
+
+    return scale > 0.0 ? error / scale : error;
+  }
+}
+
+/******************************************************************************/
+// Main
+/******************************************************************************/
+
+int
+main()
+{
+  std::mt19937 random(1);
+  int          status = 0;
+
+  for (auto const submode : SUBMODES)
+  {
+    int const nsps   = JS8::Submode::symbolSamples(submode);
+    int const cycle  = JS8::Submode::framesPerCycle(submode);
+    int const length = JS8_NUM_SYMBOLS * nsps;
+
+    // Clipped at the start, clipped at the end, and then anywhere.
+
+    std::vector<int> starts{-4 * nsps, cycle - length / 2};
+
+    while (static_cast<int>(starts.size()) < SIGNALS) starts.push_back(random() % std::max(cycle - length, 1));
+
+    double error = 0.0;
+
+    for (auto const start : starts)
+    {
+      error = std::max(error, check(submode, synthesize(submode, start, random)));
+    }
+
+    std::cout << JS8::Submode::name(submode).toStdString()
+              << ": "
+              << error
+              << (error <= TOLERANCE ? " ok" : " FAILED")
+              << std::endl;
+
+    if (error > TOLERANCE) status = 1;
+  }
+
+  FFTW::cleanup();
+
+  return status;
+}
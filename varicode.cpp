@@ -30,17 +30,15 @@
 #include "jsc.h"
 #include "decodedtext.h"
 
+#include <bit>
 #include <cmath>
+#include <optional>
 
 const int nalphabet = 41;
 QString alphabet = {"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ+-./?"}; // alphabet to encode _into_ for FT8 freetext transmission
 QString alphabet72 = {"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-+/?."};
-QString grid_pattern = {R"((?<grid>[A-X]{2}[0-9]{2}(?:[A-X]{2}(?:[0-9]{2})?)*)+)"};
 QString orig_compound_callsign_pattern = {R"((?<callsign>(\d|[A-Z])+\/?((\d|[A-Z]){2,})(\/(\d|[A-Z])+)?(\/(\d|[A-Z])+)?))"};
-QString base_callsign_pattern = {R"((?<callsign>\b(?<base>([0-9A-Z])?([0-9A-Z])([0-9])([A-Z])?([A-Z])?([A-Z])?)(?<portable>[/][P])?\b))"};
 //QString compound_callsign_pattern = {R"((?<callsign>\b(?<prefix>[A-Z0-9]{1,4}\/)?(?<base>([0-9A-Z])?([0-9A-Z])([0-9])([A-Z])?([A-Z])?([A-Z])?)(?<suffix>\/[A-Z0-9]{1,4})?)\b)"};
-QString compound_callsign_pattern = {R"((?<callsign>(?:[@]?|\b)(?<extended>[A-Z0-9\/@][A-Z0-9\/]{0,2}[\/]?[A-Z0-9\/]{0,3}[\/]?[A-Z0-9\/]{0,3})\b))"};
-QString pack_callsign_pattern = {R"(([0-9A-Z ])([0-9A-Z])([0-9])([A-Z ])([A-Z ])([A-Z ]))"};
 QString alphanumeric = {"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ /@"}; // callsign and grid alphabet
 
 QMap<QString, int> directed_cmds = {
@@ -356,6 +354,196 @@ int dbmTomwatts(int dbm){
     return iter.value();
 }
 
+/*
+ * RECOGNIZERS
+ *
+ * Hand built equivalents of the callsign and grid grammars, which sit on
+ * the decode and typeahead paths, where compiling and running a regular
+ * expression per call was the bulk of the cost. Each is written to give
+ * exactly the answer that the PCRE pattern it replaces, noted alongside,
+ * would give, including its backtracking order where that matters.
+ */
+
+static bool isDigit(QChar ch){
+    auto const c = ch.unicode();
+    return c >= '0' && c <= '9';
+}
+
+static bool isAlpha(QChar ch){
+    auto const c = ch.unicode();
+    return c >= 'A' && c <= 'Z';
+}
+
+static bool isAlnum(QChar ch){
+    return isDigit(ch) || isAlpha(ch);
+}
+
+static bool isGridAlpha(QChar ch){
+    auto const c = ch.unicode();
+    return c >= 'A' && c <= 'X';
+}
+
+// \w, which without Unicode properties is ASCII only
+static bool isWordChar(QChar ch){
+    auto const c = ch.unicode();
+    return isAlnum(ch) || (c >= 'a' && c <= 'z') || c == '_';
+}
+
+// \b at position i
+static bool isWordBoundary(QStringView s, qsizetype i){
+    bool const before = i > 0 && isWordChar(s[i - 1]);
+    bool const after = i < s.size() && isWordChar(s[i]);
+    return before != after;
+}
+
+// [0-9][A-Z]|[A-Z][0-9], anywhere in the string
+static bool hasAlphaNumericPair(QStringView s){
+    for(qsizetype i = 1; i < s.size(); i++){
+        if((isDigit(s[i - 1]) && isAlpha(s[i])) || (isAlpha(s[i - 1]) && isDigit(s[i]))){
+            return true;
+        }
+    }
+    return false;
+}
+
+// the whole string is a base callsign, i.e., matches
+//
+//   \b([0-9A-Z])?([0-9A-Z])([0-9])([A-Z])?([A-Z])?([A-Z])?([/][P])?\b
+static bool isBaseCallsign(QStringView s){
+    if(s.endsWith(u"/P")){
+        s.chop(2);
+    }
+
+    auto const isSuffix = [s](qsizetype from){
+        if(s.size() - from > 3){
+            return false;
+        }
+        for(qsizetype i = from; i < s.size(); i++){
+            if(!isAlpha(s[i])) return false;
+        }
+        return true;
+    };
+
+    auto const n = s.size();
+
+    return (n >= 2 && isAlnum(s[0]) && isDigit(s[1]) && isSuffix(2)) ||
+           (n >= 3 && isAlnum(s[0]) && isAlnum(s[1]) && isDigit(s[2]) && isSuffix(3));
+}
+
+static bool isExtendedChar(QChar ch){
+    return isAlnum(ch) || ch == '/';
+}
+
+// [from, to) matches [A-Z0-9\/]{0,2}[\/]?[A-Z0-9\/]{0,3}[\/]?[A-Z0-9\/]{0,3}, given
+// that every character in it is one of [A-Z0-9\/]; the optional slashes
+// matter only when it's longer than the 8 characters the rest can take.
+static bool isExtendedTail(QStringView s, qsizetype from, qsizetype to){
+    auto const n = to - from;
+    if(n <= 8){
+        return true;
+    }
+    for(int a = 0; a <= 2; a++){
+        for(int s1 = 0; s1 <= 1; s1++){
+            for(int b = 0; b <= 3; b++){
+                for(int s2 = 0; s2 <= 1; s2++){
+                    auto const c = n - a - s1 - b - s2;
+                    if(c < 0 || c > 3) continue;
+                    if(s1 && s[from + a] != '/') continue;
+                    if(s2 && s[from + a + s1 + b] != '/') continue;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// the end of the match of the compound callsign pattern
+//
+//   (?:[@]?|\b)[A-Z0-9\/@][A-Z0-9\/]{0,2}[\/]?[A-Z0-9\/]{0,3}[\/]?[A-Z0-9\/]{0,3}\b
+//
+// starting at position p, or -1 if there's none. The leading @ is taken
+// if present, and then, failing that, not; the \b alternative can only
+// ever match where an empty [@]? already has. Past the first character,
+// the greedy quantifiers come to the longest extent at which the tail
+// is valid and there's a word boundary.
+static qsizetype compoundCallsignEnd(QStringView s, qsizetype p){
+    auto const n = s.size();
+    auto const at = p < n && s[p] == '@';
+
+    for(auto q = p + at; q >= p; q--){
+        if(q >= n || !(isExtendedChar(s[q]) || s[q] == '@')){
+            continue;
+        }
+
+        auto run = q + 1;
+        while(run < n && run < q + 11 && isExtendedChar(s[run])){
+            run++;
+        }
+
+        for(auto end = run; end > q; end--){
+            if(isWordBoundary(s, end) && isExtendedTail(s, q + 1, end)){
+                return end;
+            }
+        }
+    }
+
+    return -1;
+}
+
+// the whole string matches ^ followed by the compound callsign pattern
+static bool isCompoundCallsignMatch(QStringView s){
+    return compoundCallsignEnd(s, 0) == s.size();
+}
+
+// [A-X]{2}[0-9]{2} at position i
+static bool isGridAt(QStringView s, qsizetype i){
+    return i + 4 <= s.size() &&
+           isGridAlpha(s[i]) && isGridAlpha(s[i + 1]) &&
+           isDigit(s[i + 2]) && isDigit(s[i + 3]);
+}
+
+// the end of the match of the grid pattern
+//
+//   ([A-X]{2}[0-9]{2}(?:[A-X]{2}(?:[0-9]{2})?)*)+
+//
+// starting at position i, where isGridAt(s, i); the inner repetition
+// takes any pairs that the outer one could, so the outer never repeats.
+static qsizetype gridEnd(QStringView s, qsizetype i){
+    auto end = i + 4;
+    while(end + 2 <= s.size() && isGridAlpha(s[end]) && isGridAlpha(s[end + 1])){
+        end += 2;
+        if(end + 2 <= s.size() && isDigit(s[end]) && isDigit(s[end + 1])){
+            end += 2;
+        }
+    }
+    return end;
+}
+
+static bool containsGrid(QStringView s){
+    for(qsizetype i = 0; i + 4 <= s.size(); i++){
+        if(isGridAt(s, i)) return true;
+    }
+    return false;
+}
+
+// ([0-9A-Z ])([0-9A-Z])([0-9])([A-Z ])([A-Z ])([A-Z ]), the whole of a 6 character string
+static bool isPackableCallsign(QStringView s){
+    auto const isAlphaOrSpace = [](QChar ch){ return isAlpha(ch) || ch == ' '; };
+
+    return s.size() == 6 &&
+           (isAlnum(s[0]) || s[0] == ' ') && isAlnum(s[1]) && isDigit(s[2]) &&
+           isAlphaOrSpace(s[3]) && isAlphaOrSpace(s[4]) && isAlphaOrSpace(s[5]);
+}
+
+static int hexValue(QChar ch){
+    auto const c = ch.unicode();
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
 QString Varicode::extendedChars(){
     static QString c;
     if(c.size() == 0){
@@ -389,19 +577,39 @@ QString Varicode::escape(const QString &text){
     return escaped;
 }
 
+// replaces each ([\x1A][0-9a-fA-F]{4}), or (([uU][+]|\\[uU])[0-9a-fA-F]{4}),
+// with the character having that code
 QString Varicode::unescape(const QString &text){
     QString unescaped(text);
 #if JS8_USE_ESCAPE_SUB_CHAR
     static const int size = 5;
-    QRegularExpression r("([\\x1A][0-9a-fA-F]{4})");
+    auto const isPrefix = [](QStringView s){ return s[0] == '\x1A'; };
 #else
     static const int size = 6;
-    QRegularExpression r("(([uU][+]|\\\\[uU])[0-9a-fA-F]{4})");
+    auto const isPrefix = [](QStringView s){
+        return ((s[0] == 'u' || s[0] == 'U') && s[1] == '+') ||
+               (s[0] == '\\' && (s[1] == 'u' || s[1] == 'U'));
+    };
 #endif
-    qsizetype pos = 0;
-    QRegularExpressionMatch match;
-    while ((pos = unescaped.indexOf(r, pos, &match)) != -1) {
-        unescaped.replace(pos++, size, QChar(match.captured(1).right(4).toUShort(0, 16)));
+    for(qsizetype pos = 0; pos + size <= unescaped.size(); pos++){
+        QStringView const candidate = QStringView(unescaped).sliced(pos, size);
+        if(!isPrefix(candidate)){
+            continue;
+        }
+
+        int code = 0;
+        for(auto const ch : candidate.last(4)){
+            auto const value = hexValue(ch);
+            if(value < 0){
+                code = -1;
+                break;
+            }
+            code = code * 16 + value;
+        }
+
+        if(code >= 0){
+            unescaped.replace(pos, size, QChar(code));
+        }
     }
 
     return unescaped;
@@ -436,6 +644,14 @@ QMap<QString, QString> Varicode::defaultHuffTable(){
     return hufftable;
 }
 
+QString const& Varicode::alphanumericTable(){
+    return alphanumeric;
+}
+
+QMap<QString, quint32> const& Varicode::basecallTable(){
+    return basecalls;
+}
+
 QString Varicode::cqString(int number){
     if(!cqs.contains(number)){
         return QString{};
@@ -510,19 +726,18 @@ bool Varicode::checksum32Valid(QString const &checksum, QString const &input){
 
 QStringList Varicode::parseCallsigns(QString const &input){
     QStringList callsigns;
-    QRegularExpression re(compound_callsign_pattern);
-    QRegularExpressionMatchIterator iter = re.globalMatch(input);
-    while(iter.hasNext()){
-        QRegularExpressionMatch match = iter.next();
-        if(!match.hasMatch()){
+    for(qsizetype pos = 0; pos < input.size();){
+        auto const end = compoundCallsignEnd(input, pos);
+        if(end < 0){
+            pos++;
             continue;
         }
-        QString callsign = match.captured("callsign").trimmed();
+        QString callsign = input.sliced(pos, end - pos);
+        pos = end;
         if(!Varicode::isValidCallsign(callsign, nullptr)){
             continue;
         }
-        QRegularExpression m(grid_pattern);
-        if(m.match(callsign).hasMatch()){
+        if(containsGrid(callsign)){
             continue;
         }
         callsigns.append(callsign);
@@ -532,14 +747,14 @@ QStringList Varicode::parseCallsigns(QString const &input){
 
 QStringList Varicode::parseGrids(const QString &input){
     QStringList grids;
-    QRegularExpression re(grid_pattern);
-    QRegularExpressionMatchIterator iter = re.globalMatch(input);
-    while(iter.hasNext()){
-        QRegularExpressionMatch match = iter.next();
-        if(!match.hasMatch()){
+    for(qsizetype pos = 0; pos < input.size();){
+        if(!isGridAt(input, pos)){
+            pos++;
             continue;
         }
-        auto grid = match.captured("grid");
+        auto const end = gridEnd(input, pos);
+        auto grid = input.sliced(pos, end - pos);
+        pos = end;
         if(grid == "RR73"){
             continue;
         }
@@ -548,10 +763,15 @@ QStringList Varicode::parseGrids(const QString &input){
     return grids;
 }
 
-QList<QPair<int, QVector<bool>>> Varicode::huffEncode(const QMap<QString, QString> &huff, QString const& text){
-    QList<QPair<int, QVector<bool>>> out;
+// encode only as much of the text as it takes for the codes to come to at
+// least the number of bits provided, or all of it if that's negative, noting
+// how many characters had to be looked at
+QList<QPair<int, BitStream>> Varicode::huffEncode(const QMap<QString, QString> &huff, QString const& text, int bits, qsizetype *pExamined){
+    QList<QPair<int, BitStream>> out;
 
     int i = 0;
+    int total = 0;
+    qsizetype examined = 0;
 
     auto keys = huff.keys();
     std::sort(keys.begin(), keys.end(), [](QString const &a, QString const &b){
@@ -567,12 +787,18 @@ QList<QPair<int, QVector<bool>>> Varicode::huffEncode(const QMap<QString, QStrin
         return b < a;
     });
 
+    // keys are tried longest first, so that's as far as each attempt looks
+    auto const longest = keys.isEmpty() ? 0 : keys.first().length();
+
     while(i < text.length()){
+        examined = qMax(examined, qMin(text.length(), i + longest));
+
         bool found = false;
         foreach(auto ch, keys){
             if (QStringView(text.begin() + i, text.end()).startsWith(ch)) {
                 out.append({ ch.length(), Varicode::strToBits(huff[ch])});
                 i += ch.length();
+                total += out.last().second.size();
                 found = true;
                 break;
             }
@@ -581,34 +807,91 @@ QList<QPair<int, QVector<bool>>> Varicode::huffEncode(const QMap<QString, QStrin
         if(!found){
             i++;
         }
+
+        if(bits >= 0 && total >= bits){
+            break;
+        }
     }
 
+    if(pExamined) *pExamined = examined;
+
     return out;
 }
 
-QString Varicode::huffDecode(QMap<QString, QString> const &huff, QVector<bool> const& bitvec){
-    QString text;
+// Huffman decoding is table driven; the table is indexed by the next
+// `bits` bits of the input, the length of the longest code, and gives
+// the symbol whose code those bits start with, along with the length of
+// the code, so that each symbol takes a single lookup. The codes in use
+// on the air aren't canonical, so the table is populated from the codes
+// themselves, rather than from their lengths alone.
+struct HuffDecoder {
+    struct Entry {
+        QString symbol;
+        int length = 0;
+    };
 
-    QString bits = Varicode::bitsToStr(bitvec);
+    int bits = 0;
+    QVector<Entry> table;
 
-    // TODO: jsherer - this is naive...
-    while(bits.length() > 0){
-        bool found = false;
-        foreach(auto key, huff.keys()){
-            if(bits.startsWith(huff[key])){
-                if(key == EOT){
-                    text.append(" ");
-                    found = false;
-                    break;
+    explicit HuffDecoder(QMap<QString, QString> const &huff){
+        foreach(auto const &code, huff){
+            bits = qMax(bits, (int)code.length());
+        }
+
+        Q_ASSERT(bits <= 16);
+
+        table.resize(1 << bits);
+
+        for(auto it = huff.constBegin(); it != huff.constEnd(); ++it){
+            auto const &code = it.value();
+            if(code.isEmpty()){
+                continue;
+            }
+
+            auto const span = bits - code.length();
+            auto const first = Varicode::bitsToInt(Varicode::strToBits(code)) << span;
+
+            for(quint64 j = 0; j < (1ull << span); j++){
+                auto &entry = table[first | j];
+                if(entry.length == 0){
+                    entry.symbol = it.key();
+                    entry.length = code.length();
                 }
-                text.append(key);
-                bits = bits.mid(huff[key].length());
-                found = true;
             }
         }
-        if(!found){
+    }
+};
+
+QString Varicode::huffDecode(QMap<QString, QString> const &huff, BitStream const& bitvec){
+    static HuffDecoder const defaultDecoder(hufftable);
+
+    std::optional<HuffDecoder> customDecoder;
+    if(huff != hufftable){
+        customDecoder.emplace(huff);
+    }
+
+    auto const &decoder = customDecoder ? *customDecoder : defaultDecoder;
+
+    QString text;
+
+    int i = 0;
+    int const n = bitvec.size();
+
+    while(i < n){
+        auto const &entry = decoder.table[bitvec.read(i, decoder.bits)];
+
+        // not a code, or a code longer than what's left
+        if(entry.length == 0 || entry.length > n - i){
+            break;
+        }
+
+        if(entry.symbol == EOT){
+            text.append(" ");
             break;
         }
+
+        text.append(entry.symbol);
+        i += entry.length;
     }
 
     return text;
@@ -620,70 +903,58 @@ QSet<QString> Varicode::huffValidChars(const QMap<QString, QString> &huff){
                          keys.end());
 }
 
-// convert char* array of 0 bytes and 1 bytes to bool vector
-QVector<bool> Varicode::bytesToBits(char *bitvec, int n){
-    QVector<bool> bits;
+// convert char* array of 0 bytes and 1 bytes to a bit stream
+BitStream Varicode::bytesToBits(char *bitvec, int n){
+    BitStream bits;
     for(int i = 0; i < n; i++){
         bits.append(bitvec[i] == 0x01);
     }
     return bits;
 }
 
-// convert string of 0s and 1s to bool vector
-QVector<bool> Varicode::strToBits(QString const& bitvec){
-    QVector<bool> bits;
+// convert string of 0s and 1s to a bit stream
+BitStream Varicode::strToBits(QString const& bitvec){
+    BitStream bits;
     foreach(auto ch, bitvec){
         bits.append(ch == '1');
     }
     return bits;
 }
 
-QString Varicode::bitsToStr(QVector<bool> const& bitvec){
+QString Varicode::bitsToStr(BitStream const& bitvec){
     QString bits;
-    foreach(auto bit, bitvec){
-        bits.append(bit ? "1" : "0");
+    for(int i = 0; i < bitvec.size(); i++){
+        bits.append(bitvec.at(i) ? "1" : "0");
     }
     return bits;
 }
 
-QVector<bool> Varicode::intToBits(quint64 value, int expected){
-    QVector<bool> bits;
+// the minimal bits of value, zero padded at the front to the expected size
+BitStream Varicode::intToBits(quint64 value, int expected){
+    BitStream bits;
 
-    while(value){
-        bits.prepend((bool)(value & 1));
-        value = value >> 1;
-    }
+    int width = qMax((int)std::bit_width(value), expected);
 
-    if(expected){
-        while(bits.count() < expected){
-            bits.prepend((bool) 0);
-        }
+    while(width > BitStream::WORD_BITS){
+        auto const pad = qMin(width - BitStream::WORD_BITS, BitStream::WORD_BITS);
+        bits.append(BitStream::Word(0), pad);
+        width -= pad;
     }
 
+    bits.append(value, width);
+
     return bits;
 }
 
-quint64 Varicode::bitsToInt(QVector<bool> const value){
-    quint64 v = 0;
-    foreach(bool bit, value){
-        v = (v << 1) + (int)(bit);
-    }
-    return v;
+// the value of the last 64 bits, at most
+quint64 Varicode::bitsToInt(BitStream const& value){
+    int const n = qMin(value.size(), BitStream::WORD_BITS);
+    return value.read(value.size() - n, n);
 }
 
-quint64 Varicode::bitsToInt(QVector<bool>::ConstIterator start, int n){
-    quint64 v = 0;
-    for(int i = 0; i < n; i++){
-        int bit = (int)(*start);
-        v = (v << 1) + (int)(bit);
-        start++;
-    }
-    return v;
-}
-
-QVector<bool> Varicode::bitsListToBits(QList<QVector<bool>> &list){
-    QVector<bool> out;
-    foreach(auto vec, list){
+BitStream Varicode::bitsListToBits(QList<BitStream> &list){
+    BitStream out;
+    foreach(auto const &vec, list){
         out += vec;
     }
     return out;
@@ -810,7 +1081,7 @@ QString Varicode::pack72bits(quint64 value, quint8 rem){
 // 21 bits for the data + 1 bit for a flag indicator
 // giving us a total of 5.5 bits per character
 quint32 Varicode::packAlphaNumeric22(QString const& value, bool isFlag){
-    QString word = QString(value).replace(QRegularExpression("[^A-Z0-9/ ]"), "");
+    QString word = QString(value).removeIf([](QChar ch){ return !(isAlnum(ch) || ch == '/' || ch == ' '); });
     if(word.length() < 4){
         word = word + QString(" ").repeated(4-word.length());
     }
@@ -861,7 +1132,7 @@ QString Varicode::unpackAlphaNumeric22(quint32 packed, bool *isFlag){
 //
 // giving us a total of 4.5-5.55 bits per character
 quint64 Varicode::packAlphaNumeric50(QString const& value){
-    QString word = QString(value).replace(QRegularExpression("[^A-Z0-9 /@]"), "");
+    QString word = QString(value).removeIf([](QChar ch){ return !(isAlnum(ch) || ch == ' ' || ch == '/' || ch == '@'); });
     if(word.length() > 3 && word.at(3) != '/'){
         word.insert(3, ' ');
     }
@@ -995,12 +1266,12 @@ quint32 Varicode::packCallsign(QString const& value, bool *pPortable){
         permutations.append(callsign + " ");
     }
 
+    // permutations are at most 6 characters, so the pattern can only
+    // ever match the whole of one
     QString matched;
-    QRegularExpression m(pack_callsign_pattern);
     foreach(auto permutation, permutations){
-        auto match = m.match(permutation);
-        if(match.hasMatch()){
-            matched = match.captured(0);
+        if(isPackableCallsign(permutation)){
+            matched = permutation;
         }
     }
     if(matched.isEmpty()){
@@ -1250,13 +1521,7 @@ bool isValidCompoundCallsign(QStringView callsign){
         return true;
     }
 
-    if (callsign.length() > 2 && QRegularExpression("[0-9][A-Z]|[A-Z][0-9]")
-#if (QT_VERSION < QT_VERSION_CHECK(6, 5, 0))
-    .match(callsign)
-#else
-    .matchView(callsign)
-#endif
-    .hasMatch())
+    if (callsign.length() > 2 && hasAlphaNumericPair(callsign))
     {
         return true;
     }
@@ -1270,16 +1535,13 @@ bool Varicode::isValidCallsign(const QString &callsign, bool *pIsCompound){
         return true;
     }
 
-    auto match = QRegularExpression(base_callsign_pattern).match(callsign);
-    if(match.hasMatch() && (match.capturedLength() == callsign.length())){
+    if(isBaseCallsign(callsign)){
         if(pIsCompound) *pIsCompound = false;
-        return callsign.length() > 2 && QRegularExpression("[0-9][A-Z]|[A-Z][0-9]").match(callsign).hasMatch();
+        return callsign.length() > 2 && hasAlphaNumericPair(callsign);
     }
 
-    match = QRegularExpression("^" + compound_callsign_pattern).match(callsign);
-
-    if(match.hasMatch() && (match.capturedLength() == callsign.length())){
-        bool isValid = isValidCompoundCallsign(match.capturedView(0));
+    if(isCompoundCallsignMatch(callsign)){
+        bool isValid = isValidCompoundCallsign(callsign);
 
         if(pIsCompound) *pIsCompound = isValid;
         return isValid;
@@ -1294,19 +1556,17 @@ bool Varicode::isCompoundCallsign(const QString &callsign){
         return false;
     }
 
-    auto match = QRegularExpression(base_callsign_pattern).match(callsign);
-    if(match.hasMatch() && (match.capturedLength() == callsign.length())){
+    if(isBaseCallsign(callsign)){
         return false;
     }
 
-    match = QRegularExpression("^" + compound_callsign_pattern).match(callsign);
-    if(!match.hasMatch() || (match.capturedLength() != callsign.length())){
+    if(!isCompoundCallsignMatch(callsign)){
         return false;
     }
 
-    bool isValid = isValidCompoundCallsign(match.capturedView(0));
+    bool isValid = isValidCompoundCallsign(callsign);
 
-    qDebug() << "is valid compound?" << match.capturedView(0) << isValid;
+    qDebug() << "is valid compound?" << callsign << isValid;
 
     return isValid;
 }
@@ -1348,7 +1608,7 @@ QString Varicode::packHeartbeatMessage(QString const &text, const QString &calls
     }
 
     quint16 packed_extra = nmaxgrid; // which will display an empty string
-    if(extra.length() == 4 && QRegularExpression(grid_pattern).match(extra).hasMatch()){
+    if(extra.length() == 4 && isGridAt(extra, 0)){
         packed_extra = Varicode::packGrid(extra);
     }
 
@@ -1682,7 +1942,35 @@ QStringList Varicode::unpackDirectedMessage(const QString &text, quint8 *pType){
     return unpacked;
 }
 
-QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n){
+#define JS8_FAST_DATA_CAN_USE_HUFF 0
+
+// index of the last character of the input that can't be huffman coded in
+// a data frame, or -1 if there is none; the input from any position past it
+// can be huffman coded
+static qsizetype lastUnhuffable(const QString &input, bool fast){
+#if JS8_FAST_DATA_CAN_USE_HUFF
+    Q_UNUSED(fast);
+#else
+    if(fast){
+        return input.size();
+    }
+#endif
+
+    static QSet<QString> const validChars = Varicode::huffValidChars(Varicode::defaultHuffTable());
+    for(auto i = input.size(); i-- > 0;){
+        if(!validChars.contains(input.at(i).toUpper())){
+            return i;
+        }
+    }
+    return -1;
+}
+
+// whether all of the input can be huffman coded
+static bool isHuffable(const QString &input){
+    return lastUnhuffable(input, false) < 0;
+}
+
+QString packHuffMessage(const QString &input, const BitStream prefix, bool huffable, int *n, qsizetype *pExamined){
     static const int frameSize = 72;
 
     QString frame;
@@ -1692,7 +1980,7 @@ QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n
     // but, since none of the other frame types start with a 0, we can drop the two zeros and use
     // them for encoding the first two bits of the actuall data sent. boom!
     // The second bit is a flag that indicates this is not compressed frame (huffman coding)
-    QVector<bool> frameBits;
+    BitStream frameBits;
     if(!prefix.isEmpty()){
         frameBits << prefix;
     }
@@ -1700,21 +1988,17 @@ QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n
     int i = 0;
 
     // only pack huff messages that only contain valid chars
-    QString::const_iterator it;
-    QSet<QString> validChars = Varicode::huffValidChars(Varicode::defaultHuffTable());
-    for(it = input.constBegin(); it != input.constEnd(); it++){
-        auto ch = (*it).toUpper();
-        if(!validChars.contains(ch)){
-            if(n) *n = 0;
-            return frame;
-        }
+    if(!huffable){
+        if(n) *n = 0;
+        if(pExamined) *pExamined = 0;
+        return frame;
     }
 
     // pack using the default huff table
-    foreach(auto pair, Varicode::huffEncode(Varicode::defaultHuffTable(), input)){
+    foreach(auto pair, Varicode::huffEncode(Varicode::defaultHuffTable(), input, frameSize - frameBits.size(), pExamined)){
         auto charN = pair.first;
         auto charBits = pair.second;
-        if(frameBits.length() + charBits.length() < frameSize){
+        if(frameBits.size() + charBits.size() < frameSize){
             frameBits += charBits;
             i += charN;
             continue;
@@ -1722,9 +2006,9 @@ QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n
         break;
     }
 
-    qDebug() << "Huff bits" << frameBits.length() << "chars" << i;
+    qDebug() << "Huff bits" << frameBits.size() << "chars" << i;
 
-    int pad = frameSize - frameBits.length();
+    int pad = frameSize - frameBits.size();
     if(pad){
         // the way we will pad is this...
         // set the bit after the frame to 0 and every bit after that a 1
@@ -1734,8 +2018,8 @@ QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n
         }
     }
 
-    quint64 value = Varicode::bitsToInt(frameBits.constBegin(), 64);
-    quint8 rem = (quint8)Varicode::bitsToInt(frameBits.constBegin() + 64, 8);
+    quint64 value = frameBits.read(0, 64);
+    quint8 rem = (quint8)frameBits.read(64, 8);
     frame = Varicode::pack72bits(value, rem);
 
     if(n) *n = i;
@@ -1743,7 +2027,7 @@ QString packHuffMessage(const QString &input, const QVector<bool> prefix, int *n
     return frame;
 }
 
-QString packCompressedMessage(const QString &input, QVector<bool> prefix, int *n){
+QString packCompressedMessage(const QString &input, BitStream prefix, int *n, qsizetype *pExamined){
     static const int frameSize = 72;
 
     QString frame;
@@ -1754,17 +2038,17 @@ QString packCompressedMessage(const QString &input, QVector<bool> prefix, int *n
     // them for encoding the first two bits of the actuall data sent. boom!
     // The second bit is a flag that indicates this is a compressed frame (dense coding)
     // For fast modes, we don't use the prefix since it is indicated by the JS8CallData flag.
-    QVector<bool> frameBits;
+    BitStream frameBits;
     if(!prefix.isEmpty()){
         frameBits << prefix;
     }
 
     int i = 0;
-    foreach(auto pair, JSC::compress(input)){
+    foreach(auto pair, JSC::compress(input, frameSize - frameBits.size(), pExamined)){
         auto bits = pair.first;
         auto chars = pair.second;
 
-        if(frameBits.length() + bits.length() < frameSize){
+        if(frameBits.size() + bits.size() < frameSize){
             frameBits.append(bits);
             i += chars;
             continue;
@@ -1773,9 +2057,9 @@ QString packCompressedMessage(const QString &input, QVector<bool> prefix, int *n
         break;
     }
 
-    qDebug() << "Compressed bits" << frameBits.length() << "chars" << i;
+    qDebug() << "Compressed bits" << frameBits.size() << "chars" << i;
 
-    int pad = frameSize - frameBits.length();
+    int pad = frameSize - frameBits.size();
     if(pad){
         // the way we will pad is this...
         // set the bit after the frame to 0 and every bit after that a 1
@@ -1785,8 +2069,8 @@ QString packCompressedMessage(const QString &input, QVector<bool> prefix, int *n
         }
     }
 
-    quint64 value = Varicode::bitsToInt(frameBits.constBegin(), 64);
-    quint8 rem = (quint8)Varicode::bitsToInt(frameBits.constBegin() + 64, 8);
+    quint64 value = frameBits.read(0, 64);
+    quint8 rem = (quint8)frameBits.read(64, 8);
     frame = Varicode::pack72bits(value, rem);
 
     if(n) *n = i;
@@ -1794,24 +2078,47 @@ QString packCompressedMessage(const QString &input, QVector<bool> prefix, int *n
     return frame;
 }
 
+// pack a data frame from the start of the input, as packDataMessage() or, if
+// fast, packFastDataMessage() would, given whether all of the input can be
+// huffman coded; *pExamined is set to the number of characters that decided
+// the frame, past which the input could be anything at all
+static QString packDataFrame(const QString &input, bool fast, bool huffable, int *n, qsizetype *pExamined){
+    QString huffFrame;
+    int huffChars = 0;
+    qsizetype huffExamined = 0;
+
+    QString compressedFrame;
+    int compressedChars = 0;
+    qsizetype compressedExamined = 0;
+
+    if(fast){
+#if JS8_FAST_DATA_CAN_USE_HUFF
+        huffFrame = packHuffMessage(input, {false}, huffable, &huffChars, &huffExamined);
+        compressedFrame = packCompressedMessage(input, {true}, &compressedChars, &compressedExamined);
+#else
+        Q_UNUSED(huffable);
+        compressedFrame = packCompressedMessage(input, {}, &compressedChars, &compressedExamined);
+#endif
+    } else {
+        huffFrame = packHuffMessage(input, {true, false}, huffable, &huffChars, &huffExamined);
+        compressedFrame = packCompressedMessage(input, {true, true}, &compressedChars, &compressedExamined);
+    }
+
+    if(pExamined) *pExamined = qMax(huffExamined, compressedExamined);
+
+    if(huffChars > compressedChars){
+        if(n) *n = huffChars;
+        return huffFrame;
+    } else {
+        if(n) *n = compressedChars;
+        return compressedFrame;
+    }
+}
+
 // TODO: DEPRECATED in 2.2 (we will eventually stop transmitting these frames)
 // pack data message using 70 bits available flagged as data by the first 2 bits
 QString Varicode::packDataMessage(const QString &input, int *n){
-   QString huffFrame;
-   int huffChars = 0;
-   huffFrame = packHuffMessage(input, {true, false}, &huffChars);
-
-   QString compressedFrame;
-   int compressedChars = 0;
-   compressedFrame = packCompressedMessage(input, {true, true}, &compressedChars);
-
-   if(huffChars > compressedChars){
-       if(n) *n = huffChars;
-       return huffFrame;
-   } else {
-       if(n) *n = compressedChars;
-       return compressedFrame;
-   }
+    return packDataFrame(input, false, isHuffable(input), n, nullptr);
 }
 
 // TODO: DEPRECATED in 2.2 (still available for decoding legacy frames, but will eventually no longer be decodable)
@@ -1851,33 +2158,12 @@ QString Varicode::unpackDataMessage(const QString &text){
     return unpacked;
 }
 
-#define JS8_FAST_DATA_CAN_USE_HUFF 0
-
 // pack data message using the full 72 bits available (with the data flag in the i3bit header)
 QString Varicode::packFastDataMessage(const QString &input, int *n){
 #if JS8_FAST_DATA_CAN_USE_HUFF
-    QString huffFrame;
-    int huffChars = 0;
-    huffFrame = packHuffMessage(input, {false}, &huffChars);
-
-    QString compressedFrame;
-    int compressedChars = 0;
-    compressedFrame = packCompressedMessage(input, {true}, &compressedChars);
-
-    if(huffChars > compressedChars){
-        if(n) *n = huffChars;
-        return huffFrame;
-    } else {
-        if(n) *n = compressedChars;
-        return compressedFrame;
-    }
+    return packDataFrame(input, true, isHuffable(input), n, nullptr);
 #else
-   QString compressedFrame;
-   int compressedChars = 0;
-   compressedFrame = packCompressedMessage(input, {}, &compressedChars);
-
-   if(n) *n = compressedChars;
-   return compressedFrame;
+    return packDataFrame(input, true, false, n, nullptr);
 #endif
 }
 
@@ -1920,6 +2206,22 @@ QString Varicode::unpackFastDataMessage(const QString &text){
     return unpacked;
 }
 
+// pack the rest of a line into data frames, once it's directed or data
+static void packDataFrames(const QString &line, int submode, QList<QPair<QString, int>> &frames){
+    bool const fast = submode != Varicode::JS8CallNormal;
+    auto const unhuffable = lastUnhuffable(line, fast);
+
+    qsizetype pos = 0;
+    while(pos < line.size()){
+        int n = 0;
+        QString frame = packDataFrame(line.mid(pos), fast, unhuffable < pos, &n, nullptr);
+        if(n > 0){
+            frames.append({ frame, fast ? Varicode::JS8CallData : Varicode::JS8Call });
+            pos += n;
+        }
+    }
+}
+
 // TODO: remove the dependence on providing all this data?
 QList<QPair<QString, int>> Varicode::buildMessageFrames(QString const& mycall,
     QString const& mygrid,
@@ -1928,7 +2230,8 @@ QList<QPair<QString, int>> Varicode::buildMessageFrames(QString const& mycall,
     bool forceIdentify,
     bool forceData,
     int submode,
-    MessageInfo *pInfo){
+    MessageInfo *pInfo,
+    MessageFramePlanner *pPlanner){
 
     #define ALLOW_SEND_COMPOUND 1
     #define ALLOW_SEND_COMPOUND_DIRECTED 1
@@ -2008,7 +2311,9 @@ QList<QPair<QString, int>> Varicode::buildMessageFrames(QString const& mycall,
         }
 #endif
 
-        while(line.size() > 0){
+        // once directed or data, the rest of the line is all data frames,
+        // which are packed below, so this only leads up to the first of them
+        while(line.size() > 0 && ((!hasDirected && !hasData) || (forceIdentify && lineFrames.isEmpty()))){
           QString frame;
 
           bool useBcn = false;
@@ -2185,6 +2490,14 @@ QList<QPair<QString, int>> Varicode::buildMessageFrames(QString const& mycall,
           }
         }
 
+        if(line.size() > 0){
+            if(pPlanner){
+                pPlanner->packDataFrames(line, submode, lineFrames);
+            } else {
+                packDataFrames(line, submode, lineFrames);
+            }
+        }
+
         if(!lineFrames.isEmpty()){
             lineFrames.first().second |= Varicode::JS8CallFirst;
             lineFrames.last().second |= Varicode::JS8CallLast;
@@ -2203,6 +2516,7 @@ BuildMessageFramesThread::BuildMessageFramesThread(const QString &mycall,
     bool forceIdentify,
     bool forceData,
     int submode,
+    QSharedPointer<MessageFramePlanner> const& planner,
     QObject *parent):
     QThread(parent),
     m_mycall{mycall},
@@ -2211,11 +2525,29 @@ BuildMessageFramesThread::BuildMessageFramesThread(const QString &mycall,
     m_text{text},
     m_forceIdentify{forceIdentify},
     m_forceData{forceData},
-    m_submode{submode}
+    m_submode{submode},
+    m_planner{planner}
 {
 }
 
 void BuildMessageFramesThread::run(){
+    if(m_planner){
+        QString transmitText;
+        auto results = m_planner->plan(
+            m_mycall,
+            m_mygrid,
+            m_selectedCall,
+            m_text,
+            m_forceIdentify,
+            m_forceData,
+            m_submode,
+            &transmitText
+        );
+
+        emit resultReady(transmitText, results.length());
+        return;
+    }
+
     auto results = Varicode::buildMessageFrames(
         m_mycall,
         m_mygrid,
@@ -2238,3 +2570,95 @@ void BuildMessageFramesThread::run(){
     auto transmitText = textList.join("");
     emit resultReady(transmitText, results.length());
 }
+
+QList<QPair<QString, int>> MessageFramePlanner::plan(QString const& mycall,
+    QString const& mygrid,
+    QString const& selectedCall,
+    QString const& text,
+    bool forceIdentify,
+    bool forceData,
+    int submode,
+    QString *pTransmitText){
+
+    QMutexLocker locker(&m_mutex);
+
+    m_line = 0;
+    auto frames = Varicode::buildMessageFrames(mycall, mygrid, selectedCall, text, forceIdentify, forceData, submode, nullptr, this);
+    m_lines.resize(m_line);
+
+    if(pTransmitText){
+        // frames mostly repeat from one plan to the next, and so do their messages
+        if(submode != m_messagesSubmode){
+            m_messages.clear();
+            m_messagesSubmode = submode;
+        }
+
+        QHash<QPair<QString, int>, QString> messages;
+        QStringList textList;
+        foreach(auto frame, frames){
+            auto it = m_messages.constFind(frame);
+            auto message = it != m_messages.constEnd() ? it.value() : DecodedText(frame.first, frame.second, submode).message();
+            messages.insert(frame, message);
+            textList.append(message);
+        }
+        m_messages.swap(messages);
+
+        *pTransmitText = textList.join("");
+    }
+
+    return frames;
+}
+
+void MessageFramePlanner::packDataFrames(QString const& text, int submode, QList<QPair<QString, int>> &frames){
+    if(m_line == m_lines.size()){
+        m_lines.append(Line{});
+    }
+    auto &line = m_lines[m_line++];
+
+    if(line.submode != submode){
+        line.steps.clear();
+    }
+
+    bool const fast = submode != Varicode::JS8CallNormal;
+    auto const unhuffable = lastUnhuffable(text, fast);
+
+    qsizetype common = 0;
+    auto const size = qMin(line.text.size(), text.size());
+    while(common < size && line.text.at(common) == text.at(common)){
+        common++;
+    }
+
+    // keep the frames decided only by what's unchanged; one that examined
+    // through the end of the old text may have packed more of a longer one
+    qsizetype pos = 0;
+    qsizetype kept = 0;
+    foreach(auto const &step, line.steps){
+        auto const end = step.pos + step.examined;
+        if(end > common || (end == line.text.size() && text.size() != line.text.size())){
+            break;
+        }
+        if(step.huffable != (unhuffable < step.pos)){
+            break;
+        }
+        frames.append(step.frame);
+        pos = step.pos + step.n;
+        kept++;
+    }
+    line.steps.resize(kept);
+
+    // and pack the rest of them as packDataFrames() would
+    while(pos < text.size()){
+        int n = 0;
+        qsizetype examined = 0;
+        bool const huffable = unhuffable < pos;
+        QString frame = packDataFrame(text.mid(pos), fast, huffable, &n, &examined);
+        if(n > 0){
+            line.steps.append({ pos, n, examined, huffable, { frame, fast ? Varicode::JS8CallData : Varicode::JS8Call } });
+            frames.append(line.steps.last().frame);
+            pos += n;
+        }
+    }
+
+    line.text = text;
+    line.submode = submode;
+}
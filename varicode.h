@@ -6,11 +6,17 @@
  **/
 
 #include <QBitArray>
+#include <QHash>
+#include <QMutex>
 #include <QRegularExpression>
+#include <QSharedPointer>
 #include <QString>
 #include <QVector>
 #include <QThread>
 
+#include "BitStream.hpp"
+
+class MessageFramePlanner;
 
 class Varicode
 {
@@ -87,6 +93,8 @@ public:
     static QString lstrip(const QString& str);
 
     static QMap<QString, QString> defaultHuffTable();
+    static QString const& alphanumericTable();
+    static QMap<QString, quint32> const& basecallTable();
     static QString cqString(int number);
     static QString hbString(int number);
     static bool startsWithCQ(QString text);
@@ -103,18 +111,17 @@ public:
     static QStringList parseCallsigns(QString const &input);
     static QStringList parseGrids(QString const &input);
 
-    static QList<QPair<int, QVector<bool>>> huffEncode(const QMap<QString, QString> &huff, QString const& text);
-    static QString huffDecode(const QMap<QString, QString> &huff, QVector<bool> const& bitvec);
+    static QList<QPair<int, BitStream>> huffEncode(const QMap<QString, QString> &huff, QString const& text, int bits = -1, qsizetype *pExamined = nullptr);
+    static QString huffDecode(const QMap<QString, QString> &huff, BitStream const& bitvec);
     static QSet<QString> huffValidChars(const QMap<QString, QString> &huff);
 
-    static QVector<bool> bytesToBits(char * bitvec, int n);
-    static QVector<bool> strToBits(QString const& bitvec);
-    static QString bitsToStr(QVector<bool> const& bitvec);
+    static BitStream bytesToBits(char * bitvec, int n);
+    static BitStream strToBits(QString const& bitvec);
+    static QString bitsToStr(BitStream const& bitvec);
 
-    static QVector<bool> intToBits(quint64 value, int expected=0);
-    static quint64 bitsToInt(QVector<bool> const value);
-    static quint64 bitsToInt(QVector<bool>::ConstIterator start, int n);
-    static QVector<bool> bitsListToBits(QList<QVector<bool>> &list);
+    static BitStream intToBits(quint64 value, int expected=0);
+    static quint64 bitsToInt(BitStream const& value);
+    static BitStream bitsListToBits(QList<BitStream> &list);
 
     static quint8 unpack5bits(QString const& value);
     static QString pack5bits(quint8 packed);
@@ -187,7 +194,54 @@ public:
         bool forceIdentify,
         bool forceData,
         int submode,
-        MessageInfo *pInfo=nullptr);
+        MessageInfo *pInfo=nullptr,
+        MessageFramePlanner *pPlanner=nullptr);
+};
+
+/**
+ * Builds message frames as Varicode::buildMessageFrames() does, for text that's
+ * being typed, remembering the data frames packed from each line. A data frame
+ * depends only on the characters examined to pack it, so those up to the first
+ * frame whose examined characters have changed are reused on the next plan, and
+ * only the rest are packed again.
+ **/
+class MessageFramePlanner
+{
+public:
+    QList<QPair<QString, int>> plan(QString const& mycall,
+        QString const& mygrid,
+        QString const& selectedCall,
+        QString const& text,
+        bool forceIdentify,
+        bool forceData,
+        int submode,
+        QString *pTransmitText=nullptr);
+
+private:
+    friend class Varicode;
+
+    // a data frame packed from a position in a line
+    struct Step {
+        qsizetype pos;
+        qsizetype n;
+        qsizetype examined;
+        bool huffable;
+        QPair<QString, int> frame;
+    };
+
+    struct Line {
+        QString text;
+        int submode = -1;
+        QList<Step> steps;
+    };
+
+    void packDataFrames(QString const& text, int submode, QList<QPair<QString, int>> &frames);
+
+    QMutex m_mutex;
+    QList<Line> m_lines;
+    int m_line = 0;
+    QHash<QPair<QString, int>, QString> m_messages;
+    int m_messagesSubmode = -1;
 };
 
 
@@ -202,6 +256,7 @@ public:
                              bool forceIdentify,
                              bool forceData,
                              int submode,
+                             QSharedPointer<MessageFramePlanner> const& planner={},
                              QObject *parent=nullptr);
     void run() override;
 signals:
@@ -215,6 +270,7 @@ private:
     bool m_forceIdentify;
     bool m_forceData;
     int m_submode;
+    QSharedPointer<MessageFramePlanner> m_planner;
 };
 
 #endif // VARICODE_H
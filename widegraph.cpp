@@ -458,6 +458,15 @@ WideGraph::drawHorizontalLine(QColor const & color,
     ui->widePlot->drawHorizontalLine(color, x, width);
 }
 
+void
+WideGraph::averageSink(WF::SPlot const & savg,
+                       WF::SPlot const * slin)
+{
+  QMutexLocker lock(&m_drawLock);
+
+  ui->widePlot->setAverages(savg, slin);
+}
+
 void
 WideGraph::dataSink(WF::SPlot const & s,
                     float     const   df3)
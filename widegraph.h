@@ -47,6 +47,7 @@ public:
 
   // Manipulators
 
+  void averageSink(WF::SPlot const &, WF::SPlot const *);
   void dataSink(WF::SPlot const &, float);
   void drawDecodeLine(QColor const &, int, int);
   void drawHorizontalLine(QColor const &, int, int);